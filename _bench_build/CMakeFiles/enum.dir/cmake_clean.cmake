@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/enum.dir/main.cpp.o"
+  "CMakeFiles/enum.dir/main.cpp.o.d"
+  "enum"
+  "enum.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/enum.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
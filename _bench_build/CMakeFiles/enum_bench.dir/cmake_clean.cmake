@@ -0,0 +1,11 @@
+file(REMOVE_RECURSE
+  "CMakeFiles/enum_bench.dir/bench.cpp.o"
+  "CMakeFiles/enum_bench.dir/bench.cpp.o.d"
+  "enum_bench"
+  "enum_bench.pdb"
+)
+
+# Per-language clean rules from dependency scanning.
+foreach(lang CXX)
+  include(CMakeFiles/enum_bench.dir/cmake_clean_${lang}.cmake OPTIONAL)
+endforeach()
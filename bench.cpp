@@ -0,0 +1,652 @@
+#include "enum.h"
+#include "enum_counters.h"
+#include "enum_huffman.h"
+#include "enum_record.h"
+#include "enum_search.h"
+#include "enum_set.h"
+#include "enum_variant.h"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <mutex>
+#include <random>
+#include <set>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+#if __cplusplus >= 201703L
+#include <variant>
+#endif
+
+///////////////////////////////
+
+namespace market
+{
+  enum class Side
+  {
+    Buy,
+    Sell
+  };
+  enum class OrderType
+  {
+    Market,
+    Limit,
+    Stop,
+    StopLimit
+  };
+  enum class Venue
+  {
+    Xnys,
+    Xnas,
+    Arcx,
+    Bats,
+    Iexg
+  };
+  enum class State
+  {
+    New,
+    PartiallyFilled,
+    Filled,
+    Cancelled,
+    Rejected
+  };
+}
+ENUM_STRINGS(market::Side, "BUY", "SELL");
+ENUM_STRINGS(market::OrderType, "MARKET", "LIMIT", "STOP", "STOP_LIMIT");
+ENUM_STRINGS(market::Venue, "XNYS", "XNAS", "ARCX", "BATS", "IEXG");
+ENUM_STRINGS(market::State, "NEW", "PARTIALLY_FILLED", "FILLED", "CANCELLED", "REJECTED");
+
+enum class Status
+{
+  Error,
+  Timeout,
+  Rejected,
+  Retry,
+  Degraded,
+  Unavailable
+};
+ENUM_STRINGS(Status, "ERROR", "TIMEOUT", "REJECTED", "RETRY", "DEGRADED", "UNAVAILABLE");
+
+enum class Event
+{
+  Ok,
+  Retry,
+  Timeout,
+  Error,
+  Throttled,
+  Moved,
+  Gone,
+  Fatal
+};
+ENUM_STRINGS(Event, "OK", "RETRY", "TIMEOUT", "ERROR", "THROTTLED", "MOVED", "GONE", "FATAL");
+
+enum class ShapeKind
+{
+  Circle,
+  Square,
+  Rectangle,
+  Triangle
+};
+ENUM_STRINGS(ShapeKind, "CIRCLE", "SQUARE", "RECTANGLE", "TRIANGLE");
+
+struct Circle
+{
+  double r;
+};
+struct Square
+{
+  double side;
+};
+struct Rectangle
+{
+  double w, h;
+};
+struct Triangle
+{
+  double base, height;
+};
+
+#define CODE_VALUES(P) P##0, P##1, P##2, P##3, P##4, P##5, P##6, P##7
+#define CODE_NAMES(P) #P "_0", #P "_1", #P "_2", #P "_3", #P "_4", #P "_5", #P "_6", #P "_7"
+enum class Code
+{
+  CODE_VALUES(A),
+  CODE_VALUES(B),
+  CODE_VALUES(C),
+  CODE_VALUES(F),
+  CODE_VALUES(K),
+  CODE_VALUES(P),
+  CODE_VALUES(S),
+  CODE_VALUES(W)
+};
+ENUM_STRINGS(Code, CODE_NAMES(A), CODE_NAMES(B), CODE_NAMES(C), CODE_NAMES(F), CODE_NAMES(K), CODE_NAMES(P),
+             CODE_NAMES(S), CODE_NAMES(W));
+
+enum class WideCode
+{
+  CODE_VALUES(A),
+  CODE_VALUES(B),
+  CODE_VALUES(C),
+  CODE_VALUES(F),
+  CODE_VALUES(K),
+  CODE_VALUES(P),
+  CODE_VALUES(S),
+  CODE_VALUES(W),
+  CODE_VALUES(X)
+};
+ENUM_STRINGS(WideCode, CODE_NAMES(A), CODE_NAMES(B), CODE_NAMES(C), CODE_NAMES(F), CODE_NAMES(K), CODE_NAMES(P),
+             CODE_NAMES(S), CODE_NAMES(W), CODE_NAMES(X));
+
+///////////////////////////////
+
+namespace
+{
+  // results are folded into this so that the timed work cannot be optimized away
+  volatile std::size_t sink;
+
+  /// Best of @p runs wall-clock timings of f(), in seconds.
+  template <typename F>
+  double best_seconds(int runs, F &&f)
+  {
+    double best = 1e30;
+    for (int i = 0; i < runs; ++i)
+    {
+      const auto start = std::chrono::steady_clock::now();
+      f();
+      const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+      best = elapsed.count() < best ? elapsed.count() : best;
+    }
+    return best;
+  }
+
+  void report(const char *name, double per_second, const char *unit)
+  {
+    std::printf("%-56s %10.1f %s\n", name, per_second, unit);
+  }
+
+  /// Run f(t) on @p threads threads and wait for all of them.
+  template <typename F>
+  void run_threads(int threads, F f)
+  {
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t)
+    {
+      pool.emplace_back(f, t);
+    }
+    for (auto &thread : pool)
+    {
+      thread.join();
+    }
+  }
+
+  template <typename E>
+  const char *random_name(std::mt19937 &rng)
+  {
+    return enum_name(static_cast<E>(rng() % enum_count<E>()));
+  }
+}
+
+void bench_record_decoder()
+{
+  using namespace market;
+  constexpr std::size_t rows = 1000000;
+  std::mt19937 rng(1);
+  std::string csv;
+  for (std::size_t i = 0; i < rows; ++i)
+  {
+    csv += std::to_string(i) + ',' + random_name<Side>(rng) + ',' + random_name<OrderType>(rng) + ',' +
+           random_name<Venue>(rng) + ',' + random_name<State>(rng) + ",100\n";
+  }
+
+  const EnumRecordDecoder<Side, OrderType, Venue, State> decoder(std::array<std::size_t, 4>{{1, 2, 3, 4}});
+  const double decoded = best_seconds(5, [&] {
+    EnumRecordDecoder<Side, OrderType, Venue, State>::columns_type out;
+    sink = decoder.decode(csv.data(), csv.data() + csv.size(), out);
+  });
+
+  // the getline + enum_from_string parsing the decoder replaces
+  const double baseline = best_seconds(5, [&] {
+    std::istringstream in(csv);
+    std::vector<Side> sides;
+    std::vector<OrderType> types;
+    std::vector<Venue> venues;
+    std::vector<State> states;
+    std::string line;
+    std::string field;
+    while (std::getline(in, line))
+    {
+      std::istringstream fields(line);
+      std::getline(fields, field, ',');
+      std::getline(fields, field, ',');
+      sides.push_back(enum_from_string<Side>(field));
+      std::getline(fields, field, ',');
+      types.push_back(enum_from_string<OrderType>(field));
+      std::getline(fields, field, ',');
+      venues.push_back(enum_from_string<Venue>(field));
+      std::getline(fields, field, ',');
+      states.push_back(enum_from_string<State>(field));
+    }
+    sink = states.size();
+  });
+
+  report("record decoder, 4 enum columns of 6", rows / decoded / 1e6, "M rows/s");
+  report("getline + enum_from_string, same columns", rows / baseline / 1e6, "M rows/s");
+}
+
+void bench_find_all()
+{
+  // log lines in lower case, one in 20 carrying a status name
+  std::mt19937 rng(2);
+  const char *words[] = {"request", "handled", "in", "ms", "worker", "pid", "upstream", "cache", "miss", "user"};
+  std::string log;
+  while (log.size() < (64u << 20))
+  {
+    log += "2024-05-01t12:00:00 host" + std::to_string(rng() % 100);
+    for (int w = 0; w < 8; ++w)
+    {
+      log += ' ';
+      log += words[rng() % 10];
+    }
+    if (rng() % 20 == 0)
+    {
+      log += ' ';
+      log += random_name<Status>(rng);
+    }
+    log += '\n';
+  }
+
+  std::size_t matches = 0;
+  const double one = best_seconds(3, [&] {
+    matches = 0;
+    enum_find_all<Status>(log.data(), log.data() + log.size(), [&](std::size_t, Status) { ++matches; });
+    sink = matches;
+  });
+  const double two = best_seconds(3, [&] {
+    std::size_t n = 0;
+    enum_find_all<Status, Code>(log.data(), log.data() + log.size(), [&](std::size_t, auto) { ++n; });
+    sink = n;
+  });
+  // the std::string::find per name the matcher replaces
+  const double baseline = best_seconds(3, [&] {
+    std::size_t n = 0;
+    for (const char *name : EnumMetaInfo<Status>::Names())
+    {
+      for (auto pos = log.find(name); pos != std::string::npos; pos = log.find(name, pos + 1))
+      {
+        ++n;
+      }
+    }
+    sink = n;
+  });
+
+  const double bytes = static_cast<double>(log.size());
+  report("find_all, 6 names, 5 first bytes (SSE2 skip)", bytes / one / 1e9, "GB/s");
+  report("find_all, 6 + 64 names, 13 first bytes", bytes / two / 1e9, "GB/s");
+  report("std::string::find per name, 6 names", bytes / baseline / 1e9, "GB/s");
+}
+
+void bench_string_map()
+{
+  static constexpr auto headers = make_static_string_map<int>({
+      {"Accept", 1}, {"Accept-Encoding", 2}, {"Accept-Language", 3}, {"Authorization", 4},
+      {"Cache-Control", 5}, {"Connection", 6}, {"Content-Encoding", 7}, {"Content-Length", 8},
+      {"Content-Type", 9}, {"Cookie", 10}, {"Date", 11}, {"ETag", 12},
+      {"Expires", 13}, {"Host", 14}, {"If-Modified-Since", 15}, {"If-None-Match", 16},
+      {"Last-Modified", 17}, {"Location", 18}, {"Origin", 19}, {"Range", 20},
+      {"Referer", 21}, {"Server", 22}, {"Set-Cookie", 23}, {"Transfer-Encoding", 24},
+      {"User-Agent", 25}, {"Vary", 26}, {"Via", 27}, {"X-Forwarded-For", 28},
+  });
+  std::unordered_map<std::string, int> map;
+  for (std::size_t i = 0; i < headers.size(); ++i)
+  {
+    map.emplace(headers.key(i), headers.value(i));
+  }
+
+  // three in four keys hit
+  std::mt19937 rng(4);
+  std::vector<std::string> keys;
+  for (int i = 0; i < 4096; ++i)
+  {
+    std::string key = headers.key(rng() % headers.size());
+    keys.push_back(i % 4 == 3 ? key + "-X" : key);
+  }
+
+  constexpr int rounds = 500;
+  const double lookups = static_cast<double>(keys.size()) * rounds;
+  const double static_time = best_seconds(3, [&] {
+    int total = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+      for (const std::string &key : keys)
+      {
+        const int *value = headers.find(key.data(), key.data() + key.size());
+        total += value != nullptr ? *value : 0;
+      }
+    }
+    sink = static_cast<std::size_t>(total);
+  });
+  const double unordered_time = best_seconds(3, [&] {
+    int total = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+      for (const std::string &key : keys)
+      {
+        const auto it = map.find(key);
+        total += it != map.end() ? it->second : 0;
+      }
+    }
+    sink = static_cast<std::size_t>(total);
+  });
+
+  report("static_string_map::find, 28 header names", lookups / static_time / 1e6, "M lookups/s");
+  report("std::unordered_map<std::string, int>::find", lookups / unordered_time / 1e6, "M lookups/s");
+}
+
+struct Area
+{
+  double operator()(const Circle &c) const { return 3.14159 * c.r * c.r; }
+  double operator()(const Square &s) const { return s.side * s.side; }
+  double operator()(const Rectangle &r) const { return r.w * r.h; }
+  double operator()(const Triangle &t) const { return 0.5 * t.base * t.height; }
+};
+
+void bench_variant()
+{
+  using Shape = EnumVariant<ShapeKind, Circle, Square, Rectangle, Triangle>;
+  constexpr std::size_t count = 1u << 20;
+  constexpr int rounds = 20;
+  std::mt19937 rng(5);
+  std::vector<Shape> shapes;
+  for (std::size_t i = 0; i < count; ++i)
+  {
+    const double x = 1 + rng() % 16;
+    const auto kind = rng() % 4;
+    if (kind == 0)
+    {
+      shapes.push_back(Shape::make<ShapeKind::Circle>(Circle{x}));
+    }
+    else if (kind == 1)
+    {
+      shapes.push_back(Shape::make<ShapeKind::Square>(Square{x}));
+    }
+    else if (kind == 2)
+    {
+      shapes.push_back(Shape::make<ShapeKind::Rectangle>(Rectangle{x, 2}));
+    }
+    else
+    {
+      shapes.push_back(Shape::make<ShapeKind::Triangle>(Triangle{x, 3}));
+    }
+  }
+  const double visits = static_cast<double>(count) * rounds;
+  const double enum_time = best_seconds(3, [&] {
+    double total = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+      for (const Shape &shape : shapes)
+      {
+        total += shape.visit(Area{});
+      }
+    }
+    sink = static_cast<std::size_t>(total);
+  });
+  char name[80];
+  std::snprintf(name, sizeof(name), "EnumVariant visit, %zu-byte values", sizeof(Shape));
+  report(name, visits / enum_time / 1e6, "M visits/s");
+
+#if __cplusplus >= 201703L
+  // the std::variant plus separately kept enum that EnumVariant replaces
+  struct Tagged
+  {
+    ShapeKind kind;
+    std::variant<Circle, Square, Rectangle, Triangle> value;
+  };
+  std::vector<Tagged> tagged;
+  for (const Shape &shape : shapes)
+  {
+    shape.visit([&](const auto &value) { tagged.push_back(Tagged{shape.tag(), value}); });
+  }
+  const double std_time = best_seconds(3, [&] {
+    double total = 0;
+    for (int r = 0; r < rounds; ++r)
+    {
+      for (const Tagged &shape : tagged)
+      {
+        total += std::visit(Area{}, shape.value);
+      }
+    }
+    sink = static_cast<std::size_t>(total);
+  });
+  std::snprintf(name, sizeof(name), "std::variant + enum std::visit, %zu-byte values", sizeof(Tagged));
+  report(name, visits / std_time / 1e6, "M visits/s");
+#endif
+}
+
+void bench_counters()
+{
+  // increments spread evenly over the threads, cycling over the enumerators
+  constexpr int increments = 20000000;
+  static EnumCounters<Status> sharded;
+  static std::atomic<std::uint64_t> shared[enum_count<Status>()];
+  char name[80];
+  for (int threads : {1, 8, 16, 64})
+  {
+    const int per_thread = increments / threads;
+    const double sharded_time = best_seconds(3, [&] {
+      run_threads(threads, [&](int) {
+        for (int i = 0; i < per_thread; ++i)
+        {
+          sharded.add(static_cast<Status>(i % 6));
+        }
+      });
+    });
+    // the shared array of atomics the counters replace
+    const double shared_time = best_seconds(3, [&] {
+      run_threads(threads, [&](int) {
+        for (int i = 0; i < per_thread; ++i)
+        {
+          shared[i % 6].fetch_add(1, std::memory_order_relaxed);
+        }
+      });
+    });
+    std::snprintf(name, sizeof(name), "EnumCounters, %d threads", threads);
+    report(name, sharded_time / increments * 1e9, "ns/increment");
+    std::snprintf(name, sizeof(name), "shared std::atomic array, %d threads", threads);
+    report(name, shared_time / increments * 1e9, "ns/increment");
+  }
+  sink = sharded.value(Status::Error) + shared[0].load();
+}
+
+void bench_huffman_stream(const char *label, const std::vector<Event> &events)
+{
+  const std::size_t n = events.size();
+  const Event *first = events.data();
+  const Event *last = first + n;
+  const EnumHuffmanCodec<Event> codec(EnumHuffmanCodec<Event>::measure(first, last));
+  std::vector<std::uint8_t> huffman;
+  codec.encode(first, last, huffman);
+  std::vector<Event> decoded(n);
+  const double huffman_time = best_seconds(5, [&] {
+    codec.decode(huffman.data(), huffman.size(), decoded.data(), n);
+    sink = static_cast<std::size_t>(decoded[n / 2]);
+  });
+  if (decoded != events)
+  {
+    std::printf("huffman round trip failed\n");
+  }
+
+  // plain bit packing, 3 bits per value, 21 values per 64-bit word
+  std::vector<std::uint64_t> packed((n + 20) / 21);
+  for (std::size_t i = 0; i < n; ++i)
+  {
+    packed[i / 21] |= std::uint64_t{enum_index(events[i])} << (i % 21 * 3);
+  }
+  const double packed_time = best_seconds(5, [&] {
+    for (std::size_t i = 0; i < n; i += 21)
+    {
+      std::uint64_t word = packed[i / 21];
+      const std::size_t stop = std::min(n, i + 21);
+      for (std::size_t j = i; j < stop; ++j, word >>= 3)
+      {
+        decoded[j] = static_cast<Event>(word & 7);
+      }
+    }
+    sink = static_cast<std::size_t>(decoded[n / 2]);
+  });
+
+  // run-length coding, one value byte and one run byte per run of up to 255
+  std::vector<std::uint8_t> rle;
+  for (std::size_t i = 0; i < n;)
+  {
+    std::size_t run = 1;
+    while (i + run < n && run < 255 && events[i + run] == events[i])
+    {
+      ++run;
+    }
+    rle.push_back(static_cast<std::uint8_t>(enum_index(events[i])));
+    rle.push_back(static_cast<std::uint8_t>(run));
+    i += run;
+  }
+  const double rle_time = best_seconds(5, [&] {
+    Event *out = decoded.data();
+    for (std::size_t r = 0; r < rle.size(); r += 2)
+    {
+      out = std::fill_n(out, rle[r + 1], static_cast<Event>(rle[r]));
+    }
+    sink = static_cast<std::size_t>(decoded[n / 2]);
+  });
+
+  // decode speed is measured in output bytes
+  const double bytes = static_cast<double>(n * sizeof(Event));
+  const double values = static_cast<double>(n);
+  char name[80];
+  std::snprintf(name, sizeof(name), "huffman decode, %s, %.2f bits/value", label, huffman.size() * 8 / values);
+  report(name, bytes / huffman_time / 1e9, "GB/s");
+  std::snprintf(name, sizeof(name), "bit packing decode, %s, %.2f bits/value", label, packed.size() * 64 / values);
+  report(name, bytes / packed_time / 1e9, "GB/s");
+  std::snprintf(name, sizeof(name), "RLE decode, %s, %.2f bits/value", label, rle.size() * 8 / values);
+  report(name, bytes / rle_time / 1e9, "GB/s");
+}
+
+void bench_huffman()
+{
+  // value k with probability 2^-(k+1), independent or in runs of mean length 16
+  constexpr std::size_t values = 16u << 20;
+  std::mt19937 rng(3);
+  const auto geometric = [&] {
+    std::size_t k = 0;
+    while (k < 7 && rng() % 2 == 0)
+    {
+      ++k;
+    }
+    return static_cast<Event>(k);
+  };
+  std::vector<Event> independent(values);
+  for (Event &e : independent)
+  {
+    e = geometric();
+  }
+  std::vector<Event> runs;
+  while (runs.size() < values)
+  {
+    runs.insert(runs.end(), std::min<std::size_t>(1 + rng() % 31, values - runs.size()), geometric());
+  }
+
+  bench_huffman_stream("independent", independent);
+  bench_huffman_stream("runs of 16", runs);
+}
+
+template <typename E>
+void bench_atomic_set_of(const char *words)
+{
+  // each thread toggles its own flag and tests another one
+  constexpr int updates = 2000000;
+  char name[80];
+  for (int threads : {1, 4})
+  {
+    const int per_thread = updates / threads;
+    AtomicEnumSet<E> flags;
+    const double atomic = best_seconds(3, [&] {
+      run_threads(threads, [&](int t) {
+        const E mine = static_cast<E>(t * 9);
+        std::size_t seen = 0;
+        for (int i = 0; i < per_thread; ++i)
+        {
+          flags.insert(mine);
+          seen += flags.test(static_cast<E>(i & 63)) ? 1 : 0;
+          flags.erase(mine);
+        }
+        sink = seen;
+      });
+    });
+
+    // the mutex-guarded std::set the atomic set replaces
+    std::set<E> locked;
+    std::mutex mutex;
+    const double guarded = best_seconds(3, [&] {
+      run_threads(threads, [&](int t) {
+        const E mine = static_cast<E>(t * 9);
+        std::size_t seen = 0;
+        for (int i = 0; i < per_thread; ++i)
+        {
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.insert(mine);
+          }
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            seen += locked.count(static_cast<E>(i & 63));
+          }
+          {
+            std::lock_guard<std::mutex> lock(mutex);
+            locked.erase(mine);
+          }
+        }
+        sink = seen;
+      });
+    });
+
+    std::snprintf(name, sizeof(name), "AtomicEnumSet, %s, %d threads", words, threads);
+    report(name, updates / atomic / 1e6, "M rounds/s");
+    std::snprintf(name, sizeof(name), "std::set + mutex, %s, %d threads", words, threads);
+    report(name, updates / guarded / 1e6, "M rounds/s");
+  }
+
+  AtomicEnumSet<E> flags;
+  flags.insert(static_cast<E>(1));
+  const double snapshots = best_seconds(3, [&] {
+    std::size_t n = 0;
+    for (int i = 0; i < updates; ++i)
+    {
+      n += flags.snapshot().size();
+    }
+    sink = n;
+  });
+  std::snprintf(name, sizeof(name), "AtomicEnumSet snapshot, %s", words);
+  report(name, updates / snapshots / 1e6, "M/s");
+}
+
+void bench_atomic_set()
+{
+  bench_atomic_set_of<Code>("1 word");
+  bench_atomic_set_of<WideCode>("2 words");
+}
+
+///////////////////////////////
+
+int main()
+{
+  bench_record_decoder();
+  bench_find_all();
+  bench_atomic_set();
+  bench_huffman();
+  bench_counters();
+  bench_string_map();
+  bench_variant();
+
+  return 0;
+}
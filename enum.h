@@ -12,6 +12,8 @@
 #include <stdexcept>
 #include <utility>
 #include <array>
+#include <cstddef>
+#include <cstdint>
 
 /**
  * @brief Associate a list of string names with enumeration values.
@@ -52,28 +54,196 @@ constexpr std::array<T, N> to_array(T (&&a)[N]) noexcept
     return to_array_impl<std::remove_cv_t<T>, T, N>(std::move(a), std::make_index_sequence<N>{});
 }
 
-#define ENUM_STRINGS(E, ...)                                          \
-    static_assert(std::is_enum<E>::value, "Not an enumeration type"); \
-                                                                      \
-    template <>                                                       \
-    struct EnumMetaInfo<E>                                            \
-    {                                                                 \
-        static decltype(to_array<std::string>({__VA_ARGS__})) Info()  \
-        {                                                             \
-            return to_array<std::string>({__VA_ARGS__});              \
-        }                                                             \
-    };                                                                \
-    inline std::ostream &operator<<(std::ostream &os, const E &e)     \
-    {                                                                 \
-        os << enum_to_string(e);                                      \
-        return os;                                                    \
-    }                                                                 \
-    inline std::istream &operator>>(std::istream &is, E &e)           \
-    {                                                                 \
-        std::string s;                                                \
-        is >> s;                                                      \
-        e = enum_from_string<E>(s);                                   \
-        return is;                                                    \
+namespace enum_detail
+{
+    constexpr std::size_t cstr_length(const char *s) noexcept
+    {
+        std::size_t n = 0;
+        while (s[n] != '\0')
+        {
+            ++n;
+        }
+        return n;
+    }
+
+    constexpr bool equal_bytes(const char *a, const char *b, std::size_t n) noexcept
+    {
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            if (a[i] != b[i])
+            {
+                return false;
+            }
+        }
+        return true;
+    }
+
+    /// 32-bit FNV-1a, usable both at compile time and at run time.
+    constexpr std::uint32_t hash_bytes(const char *s, std::size_t n) noexcept
+    {
+        std::uint32_t h = 2166136261u;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            h = (h ^ static_cast<unsigned char>(s[i])) * 16777619u;
+        }
+        return h;
+    }
+
+    /// Power-of-two open-addressing table size keeping the load factor <= 1/2.
+    constexpr std::size_t table_size_for(std::size_t n) noexcept
+    {
+        std::size_t size = 1;
+        while (size < 2 * n)
+        {
+            size <<= 1;
+        }
+        return size;
+    }
+
+    /// Size of the unit of cache coherence assumed for padding shared data.
+    constexpr std::size_t cache_line_size = 64;
+
+    /// Number of set bits of @p x.
+    inline std::size_t popcount64(std::uint64_t x) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_popcountll(x));
+#else
+        x -= (x >> 1) & 0x5555555555555555u;
+        x = (x & 0x3333333333333333u) + ((x >> 2) & 0x3333333333333333u);
+        x = (x + (x >> 4)) & 0x0f0f0f0f0f0f0f0fu;
+        return static_cast<std::size_t>((x * 0x0101010101010101u) >> 56);
+#endif
+    }
+
+    /// Index of the lowest set bit of @p x, which must not be 0.
+    inline std::size_t countr_zero64(std::uint64_t x) noexcept
+    {
+#if defined(__GNUC__)
+        return static_cast<std::size_t>(__builtin_ctzll(x));
+#else
+        return popcount64((x & (0 - x)) - 1);
+#endif
+    }
+
+    /// Number of 64-bit words needed to hold @p n bits.
+    constexpr std::size_t bit_words(std::size_t n) noexcept
+    {
+        return (n + 63) / 64;
+    }
+
+    /// Narrowest unsigned type able to hold @p N distinct values.
+    template <std::size_t N>
+    using least_uint_t = std::conditional_t<(N <= 0x100), std::uint8_t,
+                                            std::conditional_t<(N <= 0x10000), std::uint16_t, std::uint32_t>>;
+
+    /// Fixed-size array whose non-const accessor is constexpr in C++14.
+    template <typename T, std::size_t N>
+    struct carray
+    {
+        T data[N > 0 ? N : 1];
+
+        constexpr T &operator[](std::size_t i) noexcept { return data[i]; }
+        constexpr const T &operator[](std::size_t i) const noexcept { return data[i]; }
+    };
+
+    /**
+     * @brief Flat, allocation-free name -> index lookup table.
+     *
+     * Names are hashed into a linear-probing table of 1-based indices
+     * (0 marks an empty slot). The whole structure can be built in a
+     * constant expression and stored in read-only data.
+     */
+    template <std::size_t N>
+    struct name_index
+    {
+        static constexpr std::size_t table_size = table_size_for(N);
+
+        carray<const char *, N> names;
+        carray<std::uint32_t, N> lengths;
+        carray<std::uint32_t, table_size> slots;
+        std::size_t max_length;
+
+        /// @return index of the name equal to [s, s + n), or N if there is none
+        constexpr std::size_t find(const char *s, std::size_t n) const noexcept
+        {
+            std::size_t slot = hash_bytes(s, n) & (table_size - 1);
+            while (slots[slot] != 0)
+            {
+                const std::size_t i = slots[slot] - 1;
+                if (lengths[i] == n && equal_bytes(names[i], s, n))
+                {
+                    return i;
+                }
+                slot = (slot + 1) & (table_size - 1);
+            }
+            return N;
+        }
+    };
+
+    /**
+     * @brief Build the index of the @p N strings names[0] .. names[N - 1].
+     *
+     * A duplicated name throws, which makes it a compile-time error when the
+     * index initializes a constexpr variable.
+     */
+    template <std::size_t N, typename Names>
+    constexpr name_index<N> make_name_index(const Names &names)
+    {
+        name_index<N> index{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const std::size_t n = cstr_length(names[i]);
+            index.names[i] = names[i];
+            index.lengths[i] = static_cast<std::uint32_t>(n);
+            index.max_length = n > index.max_length ? n : index.max_length;
+            std::size_t slot = hash_bytes(names[i], n) & (name_index<N>::table_size - 1);
+            while (index.slots[slot] != 0)
+            {
+                const std::size_t j = index.slots[slot] - 1;
+                if (index.lengths[j] == n && equal_bytes(index.names[j], names[i], n))
+                {
+                    throw std::invalid_argument("duplicate name");
+                }
+                slot = (slot + 1) & (name_index<N>::table_size - 1);
+            }
+            index.slots[slot] = static_cast<std::uint32_t>(i + 1);
+        }
+        return index;
+    }
+} // namespace enum_detail
+
+#define ENUM_STRINGS(E, ...)                                              \
+    static_assert(std::is_enum<E>::value, "Not an enumeration type");     \
+                                                                          \
+    template <>                                                           \
+    struct EnumMetaInfo<E>                                                \
+    {                                                                     \
+        static decltype(to_array<std::string>({__VA_ARGS__})) Info()      \
+        {                                                                 \
+            return to_array<std::string>({__VA_ARGS__});                  \
+        }                                                                 \
+        static constexpr decltype(to_array<const char *>({__VA_ARGS__}))  \
+        Names() noexcept                                                  \
+        {                                                                 \
+            return to_array<const char *>({__VA_ARGS__});                 \
+        }                                                                 \
+        static bool Registered() noexcept                                 \
+        {                                                                 \
+            return enum_detail::registration<E>::done;                    \
+        }                                                                 \
+    };                                                                    \
+    inline std::ostream &operator<<(std::ostream &os, const E &e)         \
+    {                                                                     \
+        os << enum_to_string(e);                                          \
+        return os;                                                        \
+    }                                                                     \
+    inline std::istream &operator>>(std::istream &is, E &e)               \
+    {                                                                     \
+        std::string s;                                                    \
+        is >> s;                                                          \
+        e = enum_from_string<E>(s);                                       \
+        return is;                                                        \
     }
 
 template <typename T>
@@ -83,35 +253,282 @@ struct EnumMetaInfo
     {
         return std::array<std::string, 0>{};
     }
+    static constexpr std::array<const char *, 0> Names() noexcept
+    {
+        return std::array<const char *, 0>{};
+    }
 };
 
+/**
+ * @brief Number of names registered for @p E with ENUM_STRINGS.
+ */
 template <typename E>
-std::string enum_to_string(const E &e)
+constexpr std::size_t enum_count() noexcept
+{
+    return std::tuple_size<decltype(EnumMetaInfo<E>::Names())>::value;
+}
+
+/**
+ * @brief Compile-time name lookup table of @p E, stored in static read-only data.
+ */
+template <typename E>
+const enum_detail::name_index<enum_count<E>()> &enum_name_index() noexcept
+{
+    static constexpr auto index = enum_detail::make_name_index<enum_count<E>()>(EnumMetaInfo<E>::Names());
+    return index;
+}
+
+/**
+ * @brief Length of the longest name of @p E.
+ */
+template <typename E>
+std::size_t enum_max_name_size() noexcept
+{
+    return enum_name_index<E>().max_length;
+}
+
+/**
+ * @brief Dense index of @p e, or enum_count<E>() if it has no name.
+ */
+template <typename E>
+constexpr std::size_t enum_index(const E &e) noexcept
 {
     using base_type = std::underlying_type_t<E>;
-    auto const &string_list = EnumMetaInfo<E>::Info();
-    const auto index = static_cast<base_type>(e);
-    const auto max_size = string_list.max_size();
+    const auto index = static_cast<std::size_t>(static_cast<base_type>(e));
+    return index < enum_count<E>() ? index : enum_count<E>();
+}
+
+/**
+ * @brief Name of @p e without allocating.
+ * @return pointer to a static null-terminated string, or nullptr if @p e has no name
+ */
+template <typename E>
+const char *enum_name(const E &e) noexcept
+{
+    const std::size_t index = enum_index(e);
+    return index < enum_count<E>() ? enum_name_index<E>().names[index] : nullptr;
+}
+
+/**
+ * @brief Length of the name returned by enum_name(), 0 if @p e has no name.
+ */
+template <typename E>
+std::size_t enum_name_size(const E &e) noexcept
+{
+    const std::size_t index = enum_index(e);
+    return index < enum_count<E>() ? enum_name_index<E>().lengths[index] : 0;
+}
+
+/**
+ * @brief Parse the name in [first, last) without allocating.
+ * @return true and sets @p e if the range is exactly one of the names of @p E
+ */
+template <typename E>
+bool enum_from_chars(const char *first, const char *last, E &e) noexcept
+{
+    const std::size_t index = enum_name_index<E>().find(first, static_cast<std::size_t>(last - first));
+    if (index == enum_count<E>())
+    {
+        return false;
+    }
+    e = static_cast<E>(index);
+    return true;
+}
+
+template <typename E>
+std::string enum_to_string(const E &e)
+{
+    const char *name = enum_name(e);
     // todo : anyway to do static check. assert(index >= max_size, "Error, enum value is not in range");
-    if (index >= static_cast<base_type>(max_size))
+    if (name == nullptr)
     {
         return std::string{};
     }
-    return string_list[index];
+    return std::string(name, enum_name_size(e));
 }
 
 template <typename E>
 E enum_from_string(const std::string &s)
 {
-    auto const &string_list = EnumMetaInfo<E>::Info();
-    const auto max_size = string_list.max_size();
-    size_t n = 0;
-    while (n < max_size && string_list[n] != s)
+    E e{};
+    // todo: error handling
+    enum_from_chars(s.data(), s.data() + s.size(), e);
+    return e;
+}
+
+/**
+ * @brief Bytes of static metadata kept for an enumeration.
+ */
+struct EnumFootprint
+{
+    std::size_t name_bytes;   ///< null-terminated name literals
+    std::size_t table_bytes;  ///< per-enumerator name pointer and length tables
+    std::size_t lookup_bytes; ///< hashed name -> value slots and bookkeeping
+
+    constexpr std::size_t total() const noexcept
+    {
+        return name_bytes + table_bytes + lookup_bytes;
+    }
+};
+
+/**
+ * @brief Metadata footprint of @p E: its names and the index behind enum_name() and enum_from_chars().
+ *
+ * Structures of optional facilities (search automaton, attributes, ...) are
+ * only emitted when used and are not included.
+ */
+template <typename E>
+constexpr EnumFootprint enum_footprint() noexcept
+{
+    using index_type = enum_detail::name_index<enum_count<E>()>;
+    const auto names = EnumMetaInfo<E>::Names();
+    std::size_t name_bytes = 0;
+    for (std::size_t i = 0; i < names.size(); ++i)
     {
-        ++n;
+        name_bytes += enum_detail::cstr_length(names[i]) + 1;
     }
-    // todo: error handling
-    return n == max_size ? E{} : static_cast<E>(n);
+    const std::size_t table_bytes = enum_count<E>() * (sizeof(const char *) + sizeof(std::uint32_t));
+    return EnumFootprint{name_bytes, table_bytes, sizeof(index_type) - table_bytes};
+}
+
+/**
+ * @brief Combined metadata footprint of all the enumerations @p Es.
+ */
+template <typename... Es>
+constexpr EnumFootprint enum_total_footprint() noexcept
+{
+    const EnumFootprint parts[] = {EnumFootprint{0, 0, 0}, enum_footprint<Es>()...};
+    EnumFootprint total{0, 0, 0};
+    for (const EnumFootprint &part : parts)
+    {
+        total.name_bytes += part.name_bytes;
+        total.table_bytes += part.table_bytes;
+        total.lookup_bytes += part.lookup_bytes;
+    }
+    return total;
+}
+
+namespace enum_detail
+{
+    inline std::vector<EnumFootprint> &footprint_registry()
+    {
+        static std::vector<EnumFootprint> registry;
+        return registry;
+    }
+
+    /**
+     * @brief Adds the footprint of @p E to footprint_registry() during static initialization.
+     *
+     * EnumMetaInfo<E>::Registered() refers to @p done, which instantiates it
+     * once per program for every enumeration declared with ENUM_STRINGS.
+     */
+    template <typename E>
+    struct registration
+    {
+        static const bool done;
+    };
+
+    template <typename E>
+    const bool registration<E>::done = (footprint_registry().push_back(enum_footprint<E>()), true);
+} // namespace enum_detail
+
+/**
+ * @brief Number of enumerations declared with ENUM_STRINGS in the whole program.
+ *
+ * Like enum_registered_footprint(), only meaningful once static
+ * initialization is complete, e.g. from main().
+ */
+inline std::size_t enum_registered_count() noexcept
+{
+    return enum_detail::footprint_registry().size();
+}
+
+/**
+ * @brief Combined metadata footprint of every enumeration declared with ENUM_STRINGS in the program.
+ */
+inline EnumFootprint enum_registered_footprint() noexcept
+{
+    EnumFootprint total{0, 0, 0};
+    for (const EnumFootprint &part : enum_detail::footprint_registry())
+    {
+        total.name_bytes += part.name_bytes;
+        total.table_bytes += part.table_bytes;
+        total.lookup_bytes += part.lookup_bytes;
+    }
+    return total;
+}
+
+/**
+ * @brief Key and value of a static_string_map entry.
+ */
+template <typename Value>
+struct static_string_entry
+{
+    const char *key;
+    Value value;
+};
+
+/**
+ * @brief Immutable map from string literals to values, usable in constant expressions.
+ *
+ * Built on the same flat name index as the ENUM_STRINGS lookup, so find()
+ * hashes the key once and never allocates. This is not a perfect hash: keys
+ * are placed by linear probing in a table at most half full, so a lookup may
+ * compare the key against more than one entry before it hits or reaches an
+ * empty slot. Create it with
+ * make_static_string_map(); @p Value must be a default-constructible literal
+ * type for the map to be constexpr.
+ */
+template <typename Value, std::size_t N>
+struct static_string_map
+{
+    enum_detail::name_index<N> index;
+    enum_detail::carray<Value, N> values;
+
+    static constexpr std::size_t size() noexcept
+    {
+        return N;
+    }
+
+    /**
+     * @return pointer to the value of the key [first, last), or nullptr if there is none
+     */
+    constexpr const Value *find(const char *first, const char *last) const noexcept
+    {
+        const std::size_t i = index.find(first, static_cast<std::size_t>(last - first));
+        return i < N ? &values[i] : nullptr;
+    }
+
+    const Value *find(const std::string &key) const noexcept
+    {
+        return find(key.data(), key.data() + key.size());
+    }
+
+    /// Key of the i-th entry, in declaration order.
+    constexpr const char *key(std::size_t i) const noexcept
+    {
+        return index.names[i];
+    }
+
+    /// Value of the i-th entry, in declaration order.
+    constexpr const Value &value(std::size_t i) const noexcept
+    {
+        return values[i];
+    }
+};
+
+template <typename Value, std::size_t N>
+constexpr static_string_map<Value, N> make_static_string_map(const static_string_entry<Value> (&entries)[N])
+{
+    enum_detail::carray<const char *, N> keys{};
+    static_string_map<Value, N> map{};
+    for (std::size_t i = 0; i < N; ++i)
+    {
+        keys[i] = entries[i].key;
+        map.values[i] = entries[i].value;
+    }
+    map.index = enum_detail::make_name_index<N>(keys);
+    return map;
 }
 
 #endif // ENUM_STRINGS_H
\ No newline at end of file
@@ -0,0 +1,112 @@
+#ifndef ENUM_ATTRIBUTE_H
+#define ENUM_ATTRIBUTE_H
+
+/**
+ * @file enum_attribute.h
+ */
+
+#include "enum.h"
+
+/**
+ * @brief Attach a typed column of per-enumerator values to an enumeration.
+ * @param E the enumeration type (registered with ENUM_STRINGS)
+ * @param TAG any type naming the attribute, e.g. an incomplete `struct is_terminal;`
+ * @param TYPE the literal type of the values
+ * @param ... one value per name of @p E, in the same order
+ *
+ * The same tag may be used with several enumerations. Like ENUM_STRINGS,
+ * the macro must be called at global namespace scope.
+ */
+#define ENUM_ATTRIBUTE(E, TAG, TYPE, ...)                                                \
+    static_assert(std::is_enum<E>::value, "Not an enumeration type");                    \
+                                                                                         \
+    template <>                                                                          \
+    struct EnumAttributeInfo<E, TAG>                                                     \
+    {                                                                                    \
+        using value_type = TYPE;                                                         \
+        static constexpr decltype(to_array<TYPE>({__VA_ARGS__})) Values() noexcept       \
+        {                                                                                \
+            return to_array<TYPE>({__VA_ARGS__});                                        \
+        }                                                                                \
+    };                                                                                   \
+    static_assert(std::tuple_size<decltype(EnumAttributeInfo<E, TAG>::Values())>::value \
+                      == enum_count<E>(),                                                \
+                  "Number of attribute values does not match number of names")
+
+template <typename E, typename Tag>
+struct EnumAttributeInfo;
+
+namespace enum_detail
+{
+    template <typename E, typename Tag>
+    constexpr carray<std::uint64_t, bit_words(enum_count<E>())> make_attribute_mask() noexcept
+    {
+        carray<std::uint64_t, bit_words(enum_count<E>())> mask{};
+        const auto values = EnumAttributeInfo<E, Tag>::Values();
+        for (std::size_t i = 0; i < values.size(); ++i)
+        {
+            if (values[i])
+            {
+                mask[i / 64] |= std::uint64_t{1} << (i % 64);
+            }
+        }
+        return mask;
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Values of attribute @p Tag of @p E, indexed by enum_index().
+ */
+template <typename Tag, typename E>
+const decltype(EnumAttributeInfo<E, Tag>::Values()) &enum_attribute_table() noexcept
+{
+    static constexpr auto table = EnumAttributeInfo<E, Tag>::Values();
+    return table;
+}
+
+/**
+ * @brief Bitmask of the enumerators of @p E whose boolean attribute @p Tag is true.
+ *
+ * Bit `i % 64` of word `i / 64` corresponds to the enumerator of index `i`.
+ */
+template <typename Tag, typename E>
+const enum_detail::carray<std::uint64_t, enum_detail::bit_words(enum_count<E>())> &enum_attribute_mask() noexcept
+{
+    static_assert(std::is_same<typename EnumAttributeInfo<E, Tag>::value_type, bool>::value,
+                  "Attribute masks are only generated for bool attributes");
+    static constexpr auto mask = enum_detail::make_attribute_mask<E, Tag>();
+    return mask;
+}
+
+namespace enum_detail
+{
+    template <typename Tag, typename E>
+    typename EnumAttributeInfo<E, Tag>::value_type attribute(const E &e, std::false_type) noexcept
+    {
+        const std::size_t index = enum_index(e);
+        return index < enum_count<E>() ? enum_attribute_table<Tag, E>()[index]
+                                       : typename EnumAttributeInfo<E, Tag>::value_type{};
+    }
+
+    template <typename Tag, typename E>
+    bool attribute(const E &e, std::true_type) noexcept
+    {
+        const std::size_t index = enum_index(e);
+        return index < enum_count<E>() && (enum_attribute_mask<Tag, E>()[index / 64] >> (index % 64) & 1) != 0;
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Value of attribute @p Tag for @p e.
+ *
+ * Boolean attributes are a single bit test in enum_attribute_mask().
+ * Returns a value-initialized attribute if @p e has no name.
+ */
+template <typename Tag, typename E>
+typename EnumAttributeInfo<E, Tag>::value_type enum_attribute(const E &e) noexcept
+{
+    using value_type = typename EnumAttributeInfo<E, Tag>::value_type;
+    return enum_detail::attribute<Tag>(e, std::is_same<value_type, bool>{});
+}
+
+#endif // ENUM_ATTRIBUTE_H
@@ -0,0 +1,146 @@
+#ifndef ENUM_COUNTERS_H
+#define ENUM_COUNTERS_H
+
+/**
+ * @file enum_counters.h
+ */
+
+#include "enum.h"
+
+#include <atomic>
+
+#if defined(__linux__)
+#include <sched.h>
+#endif
+
+namespace enum_detail
+{
+    /// Small per-thread number, assigned round-robin on first use.
+    inline std::size_t thread_slot() noexcept
+    {
+        static std::atomic<std::size_t> next{0};
+        static thread_local const std::size_t slot = next.fetch_add(1, std::memory_order_relaxed);
+        return slot;
+    }
+
+    /// Shard for the calling thread: its current CPU where the platform reports one, its thread_slot() otherwise.
+    inline std::size_t shard_hint() noexcept
+    {
+#if defined(__linux__)
+        const int cpu = sched_getcpu();
+        if (cpu >= 0)
+        {
+            return static_cast<std::size_t>(cpu);
+        }
+#endif
+        return thread_slot();
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Counters indexed by the values of @p E, sharded to avoid cache-line contention.
+ * @param E the enumeration type (registered with ENUM_STRINGS)
+ * @param Shards number of copies of the counter array
+ *
+ * On Linux an increment goes to the shard of the CPU the thread runs on, so
+ * with @p Shards at least the number of CPUs no two cores write the same
+ * shard. Elsewhere each thread is given a shard round-robin and threads
+ * whose slots are @p Shards apart share one. Increments are a relaxed
+ * fetch_add and wait-free either way. Reads sum all shards; they are not
+ * atomic with respect to concurrent increments.
+ *
+ * Each shard is followed by a cache line of padding, so shards never share a
+ * line whatever the alignment of the object, including on the heap. This
+ * costs Shards * (enum_count<E>() * 8 + 64) bytes.
+ */
+template <typename E, std::size_t Shards = 64>
+class EnumCounters
+{
+public:
+    using snapshot_type = std::array<std::uint64_t, enum_count<E>()>;
+
+    EnumCounters() noexcept
+    {
+        reset();
+    }
+
+    EnumCounters(const EnumCounters &) = delete;
+    EnumCounters &operator=(const EnumCounters &) = delete;
+
+    /**
+     * @brief Add @p n to the counter of @p e; values without a name are ignored.
+     */
+    void add(E e, std::uint64_t n = 1) noexcept
+    {
+        const std::size_t index = enum_index(e);
+        if (index < enum_count<E>())
+        {
+            shards_[enum_detail::shard_hint() % Shards].counts[index].fetch_add(n, std::memory_order_relaxed);
+        }
+    }
+
+    std::uint64_t value(E e) const noexcept
+    {
+        const std::size_t index = enum_index(e);
+        std::uint64_t total = 0;
+        if (index < enum_count<E>())
+        {
+            for (const Shard &shard : shards_)
+            {
+                total += shard.counts[index].load(std::memory_order_relaxed);
+            }
+        }
+        return total;
+    }
+
+    /**
+     * @brief Totals of all counters, indexed by enum_index().
+     */
+    snapshot_type snapshot() const noexcept
+    {
+        snapshot_type totals{};
+        for (const Shard &shard : shards_)
+        {
+            for (std::size_t i = 0; i < enum_count<E>(); ++i)
+            {
+                totals[i] += shard.counts[i].load(std::memory_order_relaxed);
+            }
+        }
+        return totals;
+    }
+
+    /**
+     * @brief Call f(name, total) for every enumerator, in index order.
+     */
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        const snapshot_type totals = snapshot();
+        for (std::size_t i = 0; i < enum_count<E>(); ++i)
+        {
+            f(enum_name_index<E>().names[i], totals[i]);
+        }
+    }
+
+    void reset() noexcept
+    {
+        for (Shard &shard : shards_)
+        {
+            for (auto &count : shard.counts)
+            {
+                count.store(0, std::memory_order_relaxed);
+            }
+        }
+    }
+
+private:
+    struct Shard
+    {
+        std::atomic<std::uint64_t> counts[enum_count<E>() > 0 ? enum_count<E>() : 1];
+        char padding[enum_detail::cache_line_size];
+    };
+
+    Shard shards_[Shards];
+};
+
+#endif // ENUM_COUNTERS_H
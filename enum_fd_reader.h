@@ -0,0 +1,272 @@
+#ifndef ENUM_FD_READER_H
+#define ENUM_FD_READER_H
+
+/**
+ * @file enum_fd_reader.h
+ */
+
+#include "enum.h"
+
+#include <algorithm>
+#include <cerrno>
+#include <condition_variable>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <system_error>
+#include <thread>
+
+#include <poll.h>
+#include <unistd.h>
+
+/**
+ * @brief Parse whitespace-separated enumerator names streamed from a file descriptor.
+ * @param E the enumeration type (registered with ENUM_STRINGS)
+ *
+ * A background thread reads the descriptor into a ring of @p buffer_count
+ * fixed buffers while the calling thread resolves tokens in place with
+ * enum_from_chars(). Tokens split across two buffers are reassembled in a
+ * carry buffer no longer than the longest name, so memory use is constant
+ * whatever the input size.
+ *
+ * The descriptor is not closed by the reader.
+ */
+template <typename E>
+class EnumFdReader
+{
+public:
+    explicit EnumFdReader(int fd, std::size_t buffer_size = 64 * 1024, std::size_t buffer_count = 4)
+        : fd_(fd),
+          buffer_size_(buffer_size),
+          buffer_count_(buffer_count),
+          buffers_(new char[buffer_size * buffer_count]),
+          sizes_(new std::size_t[buffer_count]),
+          carry_(new char[enum_max_name_size<E>() + 1])
+    {
+        if (buffer_size == 0 || buffer_count == 0)
+        {
+            throw std::invalid_argument("EnumFdReader: buffer size and count must be positive");
+        }
+        if (::pipe(wake_) != 0)
+        {
+            throw std::system_error(errno, std::generic_category(), "EnumFdReader: pipe");
+        }
+        producer_ = std::thread([this] { produce(); });
+    }
+
+    EnumFdReader(const EnumFdReader &) = delete;
+    EnumFdReader &operator=(const EnumFdReader &) = delete;
+
+    ~EnumFdReader()
+    {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            stop_ = true;
+        }
+        can_produce_.notify_one();
+        const char c = 0;
+        while (::write(wake_[1], &c, 1) < 0 && errno == EINTR)
+        {
+        }
+        producer_.join();
+        ::close(wake_[0]);
+        ::close(wake_[1]);
+    }
+
+    /**
+     * @brief Read the next enumerator.
+     * @return false once the input is exhausted
+     * @throws std::invalid_argument if a token is not a name of @p E (the token is consumed)
+     * @throws std::system_error if reading the descriptor failed
+     */
+    bool next(E &e)
+    {
+        std::size_t length = 0; // total length of a token spanning buffers
+        bool in_token = false;
+        for (;;)
+        {
+            if (cur_ == end_ && !acquire())
+            {
+                break;
+            }
+            if (!in_token)
+            {
+                while (cur_ != end_ && is_space(*cur_))
+                {
+                    ++cur_;
+                }
+                if (cur_ == end_)
+                {
+                    continue;
+                }
+                in_token = true;
+            }
+            const char *start = cur_;
+            while (cur_ != end_ && !is_space(*cur_))
+            {
+                ++cur_;
+            }
+            if (cur_ != end_ && length == 0)
+            {
+                return resolve(start, cur_, e);
+            }
+            const std::size_t capacity = enum_max_name_size<E>() + 1;
+            const std::size_t n = static_cast<std::size_t>(cur_ - start);
+            if (length < capacity)
+            {
+                std::memcpy(carry_.get() + length, start, std::min(n, capacity - length));
+            }
+            length += n;
+            if (cur_ != end_)
+            {
+                break;
+            }
+        }
+        if (!in_token)
+        {
+            return false;
+        }
+        return resolve(carry_.get(), carry_.get() + std::min(length, enum_max_name_size<E>() + 1), e);
+    }
+
+    /**
+     * @brief Read up to @p max enumerators into @p out.
+     * @return number of enumerators stored, less than @p max only at end of input
+     */
+    std::size_t read(E *out, std::size_t max)
+    {
+        std::size_t n = 0;
+        while (n < max && next(out[n]))
+        {
+            ++n;
+        }
+        return n;
+    }
+
+private:
+    static bool is_space(char c) noexcept
+    {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    }
+
+    static bool resolve(const char *first, const char *last, E &e)
+    {
+        if (!enum_from_chars(first, last, e))
+        {
+            throw std::invalid_argument("EnumFdReader: unknown name '" + std::string(first, last) + "'");
+        }
+        return true;
+    }
+
+    /// Hand the current buffer back to the producer and wait for the next filled one.
+    bool acquire()
+    {
+        std::unique_lock<std::mutex> lock(mutex_);
+        if (holding_)
+        {
+            holding_ = false;
+            tail_ = (tail_ + 1) % buffer_count_;
+            --ready_;
+            can_produce_.notify_one();
+        }
+        can_consume_.wait(lock, [this] { return ready_ > 0 || done_; });
+        if (ready_ == 0)
+        {
+            if (error_ != 0)
+            {
+                const int error = error_;
+                error_ = 0;
+                throw std::system_error(error, std::generic_category(), "EnumFdReader: read");
+            }
+            return false;
+        }
+        holding_ = true;
+        cur_ = buffers_.get() + tail_ * buffer_size_;
+        end_ = cur_ + sizes_[tail_];
+        return true;
+    }
+
+    /// Background thread: fill free buffers until end of input, error or destruction.
+    void produce()
+    {
+        std::size_t head = 0;
+        for (;;)
+        {
+            {
+                std::unique_lock<std::mutex> lock(mutex_);
+                can_produce_.wait(lock, [this] { return ready_ < buffer_count_ || stop_; });
+                if (stop_)
+                {
+                    return;
+                }
+            }
+            char *buffer = buffers_.get() + head * buffer_size_;
+            const ssize_t n = read_some(buffer);
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (n <= 0)
+            {
+                done_ = true;
+                error_ = n < 0 ? errno : 0;
+                can_consume_.notify_one();
+                return;
+            }
+            sizes_[head] = static_cast<std::size_t>(n);
+            head = (head + 1) % buffer_count_;
+            ++ready_;
+            can_consume_.notify_one();
+        }
+    }
+
+    /// read(2) that can be interrupted by the destructor through the wake pipe.
+    ssize_t read_some(char *buffer)
+    {
+        pollfd fds[2] = {{fd_, POLLIN, 0}, {wake_[0], POLLIN, 0}};
+        for (;;)
+        {
+            if (::poll(fds, 2, -1) < 0)
+            {
+                if (errno == EINTR)
+                {
+                    continue;
+                }
+                return -1;
+            }
+            if (fds[1].revents != 0)
+            {
+                return 0;
+            }
+            const ssize_t n = ::read(fd_, buffer, buffer_size_);
+            if (n >= 0 || errno != EINTR)
+            {
+                return n;
+            }
+        }
+    }
+
+    const int fd_;
+    const std::size_t buffer_size_;
+    const std::size_t buffer_count_;
+    std::unique_ptr<char[]> buffers_;
+    std::unique_ptr<std::size_t[]> sizes_;
+    std::unique_ptr<char[]> carry_;
+    int wake_[2];
+
+    // consumer-only state
+    const char *cur_ = nullptr;
+    const char *end_ = nullptr;
+    bool holding_ = false;
+    std::size_t tail_ = 0;
+
+    // shared state, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable can_produce_;
+    std::condition_variable can_consume_;
+    std::size_t ready_ = 0;
+    bool done_ = false;
+    bool stop_ = false;
+    int error_ = 0;
+
+    std::thread producer_;
+};
+
+#endif // ENUM_FD_READER_H
@@ -0,0 +1,320 @@
+#ifndef ENUM_HUFFMAN_H
+#define ENUM_HUFFMAN_H
+
+/**
+ * @file enum_huffman.h
+ */
+
+#include "enum.h"
+
+#include <algorithm>
+#include <cstring>
+#include <functional>
+#include <queue>
+
+namespace enum_detail
+{
+    /// The 8 bytes at @p p as a little-endian integer; @p p need not be aligned.
+    inline std::uint64_t load_le64(const std::uint8_t *p) noexcept
+    {
+        std::uint64_t word;
+        std::memcpy(&word, p, sizeof(word));
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        word = __builtin_bswap64(word);
+#endif
+        return word;
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Static canonical Huffman codec for sequences of @p E.
+ *
+ * The code is built from a frequency table, typically measured with
+ * measure() on representative data, and limited to max_code_length bits so
+ * decoding is one lookup in a 2^max_code_length entry table per value. Only
+ * the code lengths need to be stored with the data (code_lengths(), one byte
+ * per enumerator, next to the name dictionary) to rebuild the same codec with
+ * from_code_lengths().
+ *
+ * Enumerators with a zero frequency get no code and cannot be encoded.
+ */
+template <typename E>
+class EnumHuffmanCodec
+{
+public:
+    static constexpr unsigned max_code_length = 12;
+
+    static_assert(enum_count<E>() <= (1u << max_code_length), "Too many enumerators for EnumHuffmanCodec");
+
+    using frequencies_type = std::array<std::uint64_t, enum_count<E>()>;
+    using code_lengths_type = std::array<std::uint8_t, enum_count<E>()>;
+
+    /**
+     * @brief Count the occurrences of each enumerator in [first, last); values without a name are ignored.
+     */
+    static frequencies_type measure(const E *first, const E *last) noexcept
+    {
+        frequencies_type frequencies{};
+        for (; first != last; ++first)
+        {
+            const std::size_t i = enum_index(*first);
+            if (i < enum_count<E>())
+            {
+                ++frequencies[i];
+            }
+        }
+        return frequencies;
+    }
+
+    explicit EnumHuffmanCodec(const frequencies_type &frequencies)
+    {
+        frequencies_type scaled = frequencies;
+        for (;;)
+        {
+            lengths_ = huffman_lengths(scaled);
+            if (*std::max_element(lengths_.begin(), lengths_.end()) <= max_code_length)
+            {
+                break;
+            }
+            // flatten the distribution until the longest code fits
+            for (auto &f : scaled)
+            {
+                f = f == 0 ? 0 : (f >> 1) | 1;
+            }
+        }
+        build();
+    }
+
+    /**
+     * @throws std::invalid_argument if the lengths do not describe a prefix code
+     */
+    static EnumHuffmanCodec from_code_lengths(const code_lengths_type &lengths)
+    {
+        return EnumHuffmanCodec(lengths);
+    }
+
+    const code_lengths_type &code_lengths() const noexcept
+    {
+        return lengths_;
+    }
+
+    /**
+     * @brief Number of bits encode() produces for [first, last).
+     */
+    std::uint64_t encoded_bits(const E *first, const E *last) const noexcept
+    {
+        std::uint64_t bits = 0;
+        for (; first != last; ++first)
+        {
+            const std::size_t i = enum_index(*first);
+            bits += i < enum_count<E>() ? lengths_[i] : 0;
+        }
+        return bits;
+    }
+
+    /**
+     * @brief Append the code of every value in [first, last) to @p out, padding the last byte with zeros.
+     * @throws std::invalid_argument if a value has no code
+     */
+    void encode(const E *first, const E *last, std::vector<std::uint8_t> &out) const
+    {
+        std::uint64_t buffer = 0;
+        unsigned bits = 0;
+        for (; first != last; ++first)
+        {
+            const std::size_t i = enum_index(*first);
+            if (i >= enum_count<E>() || lengths_[i] == 0)
+            {
+                throw std::invalid_argument("EnumHuffmanCodec: value has no code");
+            }
+            buffer |= std::uint64_t{codes_[i]} << bits;
+            bits += lengths_[i];
+            while (bits >= 8)
+            {
+                out.push_back(static_cast<std::uint8_t>(buffer));
+                buffer >>= 8;
+                bits -= 8;
+            }
+        }
+        if (bits > 0)
+        {
+            out.push_back(static_cast<std::uint8_t>(buffer));
+        }
+    }
+
+    /**
+     * @brief Decode @p count values from the @p size bytes at @p data.
+     * @throws std::invalid_argument if the data is too short or holds an unassigned code
+     */
+    void decode(const std::uint8_t *data, std::size_t size, E *out, std::size_t count) const
+    {
+        const std::uint8_t *end = data + size;
+        const std::uint64_t mask = (std::uint64_t{1} << table_bits_) - 1;
+        std::uint64_t buffer = 0;
+        unsigned bits = 0;
+        std::uint64_t padding = 0; // zero bits refilled past the end
+        const auto next = [&](std::size_t k) {
+            const Entry entry = table_[buffer & mask];
+            if (entry.length == 0)
+            {
+                throw std::invalid_argument("EnumHuffmanCodec: invalid code");
+            }
+            out[k] = static_cast<E>(entry.symbol);
+            buffer >>= entry.length;
+            bits -= entry.length;
+        };
+        std::size_t k = 0;
+        // one unaligned load leaves at least 56 bits, enough for 4 codes of up to 12 bits
+        for (; k + 4 <= count && end - data >= 8; k += 4)
+        {
+            // the partial byte on top is loaded again by the next refill
+            buffer |= enum_detail::load_le64(data) << bits;
+            data += (63 - bits) >> 3;
+            bits |= 56;
+            next(k);
+            next(k + 1);
+            next(k + 2);
+            next(k + 3);
+        }
+        for (; k < count; ++k)
+        {
+            if (bits < table_bits_)
+            {
+                // past the end, refill with zeros; overruns are detected below
+                while (bits <= 56)
+                {
+                    if (data != end)
+                    {
+                        buffer |= std::uint64_t{*data++} << bits;
+                    }
+                    else
+                    {
+                        padding += 8;
+                    }
+                    bits += 8;
+                }
+            }
+            next(k);
+        }
+        // the input was overrun if some of the zero padding was consumed
+        if (bits < padding)
+        {
+            throw std::invalid_argument("EnumHuffmanCodec: truncated input");
+        }
+    }
+
+private:
+    struct Entry
+    {
+        std::uint16_t symbol;
+        std::uint8_t length; // 0 for a bit pattern that starts no code
+    };
+
+    explicit EnumHuffmanCodec(const code_lengths_type &lengths) : lengths_(lengths)
+    {
+        build();
+    }
+
+    static code_lengths_type huffman_lengths(const frequencies_type &frequencies)
+    {
+        code_lengths_type lengths{};
+        // nodes 0..N-1 are leaves, internal nodes follow; parent links give the depths
+        std::vector<std::size_t> parent;
+        using Item = std::pair<std::uint64_t, std::size_t>;
+        std::priority_queue<Item, std::vector<Item>, std::greater<Item>> queue;
+        for (std::size_t i = 0; i < frequencies.size(); ++i)
+        {
+            parent.push_back(0);
+            if (frequencies[i] != 0)
+            {
+                queue.emplace(frequencies[i], i);
+            }
+        }
+        if (queue.size() == 1)
+        {
+            lengths[queue.top().second] = 1;
+            return lengths;
+        }
+        while (queue.size() > 1)
+        {
+            const Item a = queue.top();
+            queue.pop();
+            const Item b = queue.top();
+            queue.pop();
+            parent[a.second] = parent[b.second] = parent.size();
+            parent.push_back(0);
+            queue.emplace(a.first + b.first, parent.size() - 1);
+        }
+        for (std::size_t i = 0; i < frequencies.size(); ++i)
+        {
+            if (frequencies[i] != 0)
+            {
+                std::size_t depth = 0;
+                for (std::size_t node = i; node != parent.size() - 1; node = parent[node])
+                {
+                    ++depth;
+                }
+                lengths[i] = static_cast<std::uint8_t>(std::min<std::size_t>(depth, 255));
+            }
+        }
+        return lengths;
+    }
+
+    /// Assign canonical codes (stored bit-reversed for LSB-first output) and fill the decode table.
+    void build()
+    {
+        table_bits_ = 1;
+        std::uint64_t kraft = 0; // sum of 2^(max_code_length - length)
+        for (std::uint8_t length : lengths_)
+        {
+            if (length > max_code_length)
+            {
+                throw std::invalid_argument("EnumHuffmanCodec: code too long");
+            }
+            if (length != 0)
+            {
+                table_bits_ = std::max<unsigned>(table_bits_, length);
+                kraft += std::uint64_t{1} << (max_code_length - length);
+            }
+        }
+        if (kraft > (std::uint64_t{1} << max_code_length))
+        {
+            throw std::invalid_argument("EnumHuffmanCodec: lengths do not form a prefix code");
+        }
+
+        table_.assign(std::size_t{1} << table_bits_, Entry{0, 0});
+        std::uint32_t code = 0;
+        for (unsigned length = 1; length <= table_bits_; ++length)
+        {
+            for (std::size_t i = 0; i < enum_count<E>(); ++i)
+            {
+                if (lengths_[i] != length)
+                {
+                    continue;
+                }
+                std::uint32_t reversed = 0;
+                for (unsigned b = 0; b < length; ++b)
+                {
+                    reversed |= (code >> b & 1) << (length - 1 - b);
+                }
+                codes_[i] = reversed;
+                for (std::size_t fill = reversed; fill < table_.size(); fill += std::size_t{1} << length)
+                {
+                    table_[fill] = Entry{static_cast<std::uint16_t>(i), static_cast<std::uint8_t>(length)};
+                }
+                ++code;
+            }
+            code <<= 1;
+        }
+    }
+
+    code_lengths_type lengths_{};
+    std::array<std::uint32_t, enum_count<E>()> codes_{};
+    std::vector<Entry> table_;
+    unsigned table_bits_ = 1;
+};
+
+template <typename E>
+constexpr unsigned EnumHuffmanCodec<E>::max_code_length;
+
+#endif // ENUM_HUFFMAN_H
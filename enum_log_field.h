@@ -0,0 +1,200 @@
+#ifndef ENUM_LOG_FIELD_H
+#define ENUM_LOG_FIELD_H
+
+/**
+ * @file enum_log_field.h
+ */
+
+#include "enum.h"
+
+/**
+ * @brief Declare a structured-log field holding values of an enumeration.
+ * @param E the enumeration type (registered with ENUM_STRINGS)
+ * @param TAG any type naming the field, e.g. an incomplete `struct state_field;`
+ * @param KEY the field name (C-string literal)
+ *
+ * Enables enum_kv_fragment<TAG>() and enum_json_fragment<TAG>(), which return
+ * the whole `KEY=NAME` or `"KEY":"NAME"` text of a value, concatenated at
+ * compile time. Like ENUM_STRINGS, the macro must be called at global
+ * namespace scope.
+ */
+#define ENUM_LOG_FIELD(E, TAG, KEY)                                   \
+    static_assert(std::is_enum<E>::value, "Not an enumeration type"); \
+                                                                      \
+    template <>                                                       \
+    struct EnumLogFieldInfo<E, TAG>                                   \
+    {                                                                 \
+        static constexpr const char *Key() noexcept                   \
+        {                                                             \
+            return KEY;                                               \
+        }                                                             \
+    }
+
+template <typename E, typename Tag>
+struct EnumLogFieldInfo;
+
+/**
+ * @brief Pre-formatted text, null-terminated, in static storage.
+ */
+struct EnumFragment
+{
+    const char *data;
+    std::size_t size;
+};
+
+namespace enum_detail
+{
+    /// Length of @p s once escaped as the content of a JSON string.
+    constexpr std::size_t json_escaped_length(const char *s) noexcept
+    {
+        std::size_t n = 0;
+        for (; *s != '\0'; ++s)
+        {
+            const auto c = static_cast<unsigned char>(*s);
+            n += c == '"' || c == '\\' ? 2 : c < 0x20 ? 6 : 1;
+        }
+        return n;
+    }
+
+    template <typename Chars>
+    constexpr std::size_t append_json_escaped(Chars &out, std::size_t pos, const char *s) noexcept
+    {
+        constexpr const char hex[] = "0123456789abcdef";
+        for (; *s != '\0'; ++s)
+        {
+            const auto c = static_cast<unsigned char>(*s);
+            if (c == '"' || c == '\\')
+            {
+                out[pos++] = '\\';
+                out[pos++] = *s;
+            }
+            else if (c < 0x20)
+            {
+                out[pos++] = '\\';
+                out[pos++] = 'u';
+                out[pos++] = '0';
+                out[pos++] = '0';
+                out[pos++] = hex[c >> 4];
+                out[pos++] = hex[c & 0xf];
+            }
+            else
+            {
+                out[pos++] = *s;
+            }
+        }
+        return pos;
+    }
+
+    template <typename Chars>
+    constexpr std::size_t append(Chars &out, std::size_t pos, const char *s) noexcept
+    {
+        for (; *s != '\0'; ++s)
+        {
+            out[pos++] = *s;
+        }
+        return pos;
+    }
+
+    /// All fragments of one field, each null-terminated, in one blob.
+    template <std::size_t N, std::size_t Bytes>
+    struct fragment_table
+    {
+        carray<char, Bytes> chars;
+        carray<std::uint32_t, N + 1> offsets;
+
+        EnumFragment get(std::size_t i) const noexcept
+        {
+            return i < N ? EnumFragment{&chars[offsets[i]], offsets[i + 1] - offsets[i] - 1} : EnumFragment{"", 0};
+        }
+    };
+
+    template <typename E>
+    constexpr std::size_t kv_bytes(const char *key) noexcept
+    {
+        const auto names = EnumMetaInfo<E>::Names();
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            n += cstr_length(key) + 1 + cstr_length(names[i]) + 1;
+        }
+        return n;
+    }
+
+    template <typename E>
+    constexpr std::size_t json_bytes(const char *key) noexcept
+    {
+        const auto names = EnumMetaInfo<E>::Names();
+        std::size_t n = 0;
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            n += json_escaped_length(key) + json_escaped_length(names[i]) + 6;
+        }
+        return n;
+    }
+
+    template <typename E, std::size_t Bytes>
+    constexpr fragment_table<enum_count<E>(), Bytes> make_kv_fragments(const char *key) noexcept
+    {
+        fragment_table<enum_count<E>(), Bytes> table{};
+        const auto names = EnumMetaInfo<E>::Names();
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            table.offsets[i] = static_cast<std::uint32_t>(pos);
+            pos = append(table.chars, pos, key);
+            table.chars[pos++] = '=';
+            pos = append(table.chars, pos, names[i]);
+            table.chars[pos++] = '\0';
+        }
+        table.offsets[names.size()] = static_cast<std::uint32_t>(pos);
+        return table;
+    }
+
+    template <typename E, std::size_t Bytes>
+    constexpr fragment_table<enum_count<E>(), Bytes> make_json_fragments(const char *key) noexcept
+    {
+        fragment_table<enum_count<E>(), Bytes> table{};
+        const auto names = EnumMetaInfo<E>::Names();
+        std::size_t pos = 0;
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            table.offsets[i] = static_cast<std::uint32_t>(pos);
+            table.chars[pos++] = '"';
+            pos = append_json_escaped(table.chars, pos, key);
+            table.chars[pos++] = '"';
+            table.chars[pos++] = ':';
+            table.chars[pos++] = '"';
+            pos = append_json_escaped(table.chars, pos, names[i]);
+            table.chars[pos++] = '"';
+            table.chars[pos++] = '\0';
+        }
+        table.offsets[names.size()] = static_cast<std::uint32_t>(pos);
+        return table;
+    }
+} // namespace enum_detail
+
+/**
+ * @brief `KEY=NAME` for @p e, or an empty fragment if @p e has no name.
+ */
+template <typename Tag, typename E>
+EnumFragment enum_kv_fragment(const E &e) noexcept
+{
+    static constexpr auto table =
+        enum_detail::make_kv_fragments<E, enum_detail::kv_bytes<E>(EnumLogFieldInfo<E, Tag>::Key())>(
+            EnumLogFieldInfo<E, Tag>::Key());
+    return table.get(enum_index(e));
+}
+
+/**
+ * @brief `"KEY":"NAME"` for @p e, JSON-escaped, or an empty fragment if @p e has no name.
+ */
+template <typename Tag, typename E>
+EnumFragment enum_json_fragment(const E &e) noexcept
+{
+    static constexpr auto table =
+        enum_detail::make_json_fragments<E, enum_detail::json_bytes<E>(EnumLogFieldInfo<E, Tag>::Key())>(
+            EnumLogFieldInfo<E, Tag>::Key());
+    return table.get(enum_index(e));
+}
+
+#endif // ENUM_LOG_FIELD_H
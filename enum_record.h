@@ -0,0 +1,190 @@
+#ifndef ENUM_RECORD_H
+#define ENUM_RECORD_H
+
+/**
+ * @file enum_record.h
+ */
+
+#include "enum.h"
+
+#include <cstring>
+#include <tuple>
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace enum_detail
+{
+    /// First position in [p, last) holding @p delimiter or '\n', or last.
+    inline const char *find_field_end(const char *p, const char *last, char delimiter) noexcept
+    {
+#if defined(__SSE2__)
+        const __m128i d = _mm_set1_epi8(delimiter);
+        const __m128i nl = _mm_set1_epi8('\n');
+        while (last - p >= 16)
+        {
+            const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+            const int mask = _mm_movemask_epi8(_mm_or_si128(_mm_cmpeq_epi8(v, d), _mm_cmpeq_epi8(v, nl)));
+            if (mask != 0)
+            {
+                return p + __builtin_ctz(static_cast<unsigned>(mask));
+            }
+            p += 16;
+        }
+#endif
+        while (p != last && *p != delimiter && *p != '\n')
+        {
+            ++p;
+        }
+        return p;
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Position of an unparsable enum field, both 0-based.
+ */
+struct EnumRecordError
+{
+    std::size_t row;
+    std::size_t column;
+};
+
+/**
+ * @brief Decode several enum columns of delimited records into one vector per column.
+ * @param Es the enumeration type bound to each decoded column (registered with ENUM_STRINGS)
+ *
+ * Fields are located with a vectorised delimiter scan and resolved in place
+ * with enum_from_chars(), without copying them into strings. Columns that are
+ * not bound are skipped, and the rest of a line after the last bound column
+ * is skipped with memchr(). Quoting is not supported.
+ *
+ * Every row appends exactly one value to each output vector, E{} for a field
+ * that is missing or invalid, so the outputs stay aligned by row.
+ */
+template <typename... Es>
+class EnumRecordDecoder
+{
+public:
+    using columns_type = std::tuple<std::vector<Es>...>;
+    static constexpr std::size_t binding_count = sizeof...(Es);
+
+    /**
+     * @param columns the record column each enumeration type is read from, in the order of @p Es
+     * @param delimiter field separator
+     */
+    explicit EnumRecordDecoder(const std::array<std::size_t, sizeof...(Es)> &columns, char delimiter = ',')
+        : columns_(columns), delimiter_(delimiter)
+    {
+        std::size_t max_column = 0;
+        for (std::size_t column : columns)
+        {
+            max_column = column > max_column ? column : max_column;
+        }
+        slots_.assign(max_column + 1, binding_count);
+        for (std::size_t i = 0; i < binding_count; ++i)
+        {
+            if (slots_[columns[i]] != binding_count)
+            {
+                throw std::invalid_argument("EnumRecordDecoder: column bound twice");
+            }
+            slots_[columns[i]] = i;
+        }
+    }
+
+    /**
+     * @brief Decode all newline-terminated records in [first, last), the last newline being optional.
+     * @param out receives one value per record in each column vector
+     * @param errors if not null, receives the position of every invalid or missing field
+     * @return number of records decoded
+     */
+    std::size_t decode(const char *first, const char *last, columns_type &out,
+                       std::vector<EnumRecordError> *errors = nullptr) const
+    {
+        const parse_fn *parse = parsers(std::index_sequence_for<Es...>{});
+        std::size_t row = 0;
+        std::vector<bool> seen(binding_count);
+        const char *p = first;
+        while (p != last)
+        {
+            std::size_t column = 0;
+            std::size_t found = 0;
+            for (;;)
+            {
+                const char *end = enum_detail::find_field_end(p, last, delimiter_);
+                const std::size_t slot = column < slots_.size() ? slots_[column] : binding_count;
+                if (slot != binding_count)
+                {
+                    const char *field_end = end != p && end[-1] == '\r' && (end == last || *end == '\n') ? end - 1 : end;
+                    if (!parse[slot](p, field_end, out) && errors != nullptr)
+                    {
+                        errors->push_back(EnumRecordError{row, column});
+                    }
+                    seen[slot] = true;
+                    ++found;
+                }
+                if (end == last || *end == '\n' || found == binding_count)
+                {
+                    p = end;
+                    break;
+                }
+                p = end + 1;
+                ++column;
+            }
+            if (p != last && *p != '\n')
+            {
+                const void *nl = std::memchr(p, '\n', static_cast<std::size_t>(last - p));
+                p = nl != nullptr ? static_cast<const char *>(nl) : last;
+            }
+            if (p != last)
+            {
+                ++p;
+            }
+            if (found != binding_count)
+            {
+                for (std::size_t slot = 0; slot < binding_count; ++slot)
+                {
+                    if (!seen[slot])
+                    {
+                        parse[slot](p, p, out);
+                        if (errors != nullptr)
+                        {
+                            errors->push_back(EnumRecordError{row, columns_[slot]});
+                        }
+                    }
+                }
+            }
+            seen.assign(binding_count, false);
+            ++row;
+        }
+        return row;
+    }
+
+private:
+    using parse_fn = bool (*)(const char *, const char *, columns_type &);
+
+    template <std::size_t I>
+    static bool parse_field(const char *first, const char *last, columns_type &out)
+    {
+        std::tuple_element_t<I, std::tuple<Es...>> e{};
+        const bool ok = first != last && enum_from_chars(first, last, e);
+        std::get<I>(out).push_back(e);
+        return ok;
+    }
+
+    template <std::size_t... I>
+    static const parse_fn *parsers(std::index_sequence<I...>) noexcept
+    {
+        static constexpr parse_fn table[] = {&parse_field<I>...};
+        return table;
+    }
+
+    std::array<std::size_t, sizeof...(Es)> columns_;
+    std::vector<std::size_t> slots_; // record column -> binding, binding_count if unbound
+    char delimiter_;
+};
+
+template <typename... Es>
+constexpr std::size_t EnumRecordDecoder<Es...>::binding_count;
+
+#endif // ENUM_RECORD_H
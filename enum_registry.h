@@ -0,0 +1,197 @@
+#ifndef ENUM_REGISTRY_H
+#define ENUM_REGISTRY_H
+
+/**
+ * @file enum_registry.h
+ */
+
+#include "enum_runtime.h"
+
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <memory>
+#include <mutex>
+
+/**
+ * @brief Runtime enumeration that can gain names while other threads keep reading it.
+ *
+ * Writers rebuild a RuntimeEnum with the new names appended and publish it;
+ * existing values never change. Readers go through a per-thread Reader that
+ * caches the current table, so lookups involve no lock and no atomic. A
+ * reader sees new names after its next refresh(), which is also its
+ * quiescent point: a retired table is freed once every reader has refreshed
+ * past the epoch in which it was replaced (quiescent-state-based reclamation).
+ *
+ * All readers must be destroyed before the registry.
+ */
+class ExtensibleEnumRegistry
+{
+public:
+    using value_type = RuntimeEnum::value_type;
+
+    /**
+     * @brief Per-thread read handle; not to be shared between threads.
+     */
+    class Reader
+    {
+    public:
+        explicit Reader(ExtensibleEnumRegistry &registry) : registry_(registry)
+        {
+            std::lock_guard<std::mutex> lock(registry_.mutex_);
+            registry_.readers_.push_back(this);
+            refresh();
+        }
+
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+
+        ~Reader()
+        {
+            std::lock_guard<std::mutex> lock(registry_.mutex_);
+            auto &readers = registry_.readers_;
+            readers.erase(std::find(readers.begin(), readers.end(), this));
+        }
+
+        /**
+         * @brief Pick up the latest table and declare that the previous one is no longer referenced.
+         */
+        void refresh() noexcept
+        {
+            const std::uint64_t epoch = registry_.epoch_.load(std::memory_order_acquire);
+            table_ = registry_.current_.load(std::memory_order_acquire);
+            epoch_.store(epoch, std::memory_order_release);
+        }
+
+        /**
+         * @brief Table seen by this reader, valid until the next refresh().
+         */
+        const RuntimeEnum &table() const noexcept
+        {
+            return *table_;
+        }
+
+        const char *name(value_type value) const noexcept
+        {
+            return table_->name(value);
+        }
+
+        std::size_t name_size(value_type value) const noexcept
+        {
+            return table_->name_size(value);
+        }
+
+        bool from_chars(const char *first, const char *last, value_type &value) const noexcept
+        {
+            return table_->from_chars(first, last, value);
+        }
+
+    private:
+        friend class ExtensibleEnumRegistry;
+
+        ExtensibleEnumRegistry &registry_;
+        const RuntimeEnum *table_ = nullptr;
+        std::atomic<std::uint64_t> epoch_{0};
+    };
+
+    explicit ExtensibleEnumRegistry(const std::vector<std::string> &names = {})
+        : names_(names), owned_(new RuntimeEnum(names_))
+    {
+        current_.store(owned_.get(), std::memory_order_release);
+    }
+
+    ExtensibleEnumRegistry(const ExtensibleEnumRegistry &) = delete;
+    ExtensibleEnumRegistry &operator=(const ExtensibleEnumRegistry &) = delete;
+
+    /**
+     * @brief Add the names that are not registered yet and publish the rebuilt table.
+     * @return the value of each name, in order
+     */
+    std::vector<value_type> add(const std::vector<std::string> &names)
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        std::vector<value_type> values;
+        values.reserve(names.size());
+        const std::size_t old_size = names_.size();
+        for (const std::string &name : names)
+        {
+            value_type value = 0;
+            if (!owned_->from_chars(name.data(), name.data() + name.size(), value))
+            {
+                const auto added = std::find(names_.begin() + static_cast<std::ptrdiff_t>(old_size), names_.end(), name);
+                value = static_cast<value_type>(added - names_.begin());
+                if (added == names_.end())
+                {
+                    names_.push_back(name);
+                }
+            }
+            values.push_back(value);
+        }
+        if (names_.size() != old_size)
+        {
+            publish(std::unique_ptr<RuntimeEnum>(new RuntimeEnum(names_)));
+        }
+        reclaim();
+        return values;
+    }
+
+    value_type add(const std::string &name)
+    {
+        return add(std::vector<std::string>{name}).front();
+    }
+
+    /**
+     * @brief Number of retired tables still waiting for readers to refresh.
+     */
+    std::size_t retired() const
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        return retired_.size();
+    }
+
+    /**
+     * @brief Free the retired tables that no reader can still reference.
+     */
+    void collect()
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        reclaim();
+    }
+
+private:
+    struct Retired
+    {
+        std::unique_ptr<RuntimeEnum> table;
+        std::uint64_t epoch; // readers at this epoch or later no longer see the table
+    };
+
+    void publish(std::unique_ptr<RuntimeEnum> table)
+    {
+        current_.store(table.get(), std::memory_order_release);
+        const std::uint64_t epoch = epoch_.fetch_add(1, std::memory_order_acq_rel) + 1;
+        retired_.push_back(Retired{std::move(owned_), epoch});
+        owned_ = std::move(table);
+    }
+
+    void reclaim()
+    {
+        std::uint64_t oldest = std::numeric_limits<std::uint64_t>::max();
+        for (const Reader *reader : readers_)
+        {
+            oldest = std::min(oldest, reader->epoch_.load(std::memory_order_acquire));
+        }
+        retired_.erase(std::remove_if(retired_.begin(), retired_.end(),
+                                      [oldest](const Retired &r) { return r.epoch <= oldest; }),
+                       retired_.end());
+    }
+
+    mutable std::mutex mutex_;
+    std::vector<std::string> names_;
+    std::unique_ptr<RuntimeEnum> owned_;
+    std::vector<Retired> retired_;
+    std::vector<Reader *> readers_;
+    std::atomic<const RuntimeEnum *> current_{nullptr};
+    std::atomic<std::uint64_t> epoch_{0};
+};
+
+#endif // ENUM_REGISTRY_H
@@ -0,0 +1,129 @@
+#ifndef ENUM_RUNTIME_H
+#define ENUM_RUNTIME_H
+
+/**
+ * @file enum_runtime.h
+ */
+
+#include "enum.h"
+
+#include <cstring>
+
+/**
+ * @brief Enumeration whose names are only known at run time, e.g. loaded from reference data.
+ *
+ * Values are the dense indices 0..size()-1 in the order the names were given.
+ * Names are stored null-terminated in one contiguous blob, and lookup uses
+ * the same hashing and linear-probing layout as the compile-time name index
+ * of ENUM_STRINGS, so neither direction allocates.
+ */
+class RuntimeEnum
+{
+public:
+    using value_type = std::uint32_t;
+
+    RuntimeEnum() = default;
+
+    /**
+     * @throws std::invalid_argument if a name is given twice
+     */
+    explicit RuntimeEnum(const std::vector<std::string> &names)
+    {
+        std::size_t blob_size = 0;
+        for (const std::string &name : names)
+        {
+            blob_size += name.size() + 1;
+        }
+        blob_.reserve(blob_size);
+        offsets_.reserve(names.size() + 1);
+        offsets_.push_back(0);
+        slots_.assign(enum_detail::table_size_for(names.size()), 0);
+        for (const std::string &name : names)
+        {
+            add(name.data(), name.size());
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        return offsets_.empty() ? 0 : offsets_.size() - 1;
+    }
+
+    /**
+     * @return the null-terminated name of @p value, or nullptr if it is out of range
+     */
+    const char *name(value_type value) const noexcept
+    {
+        return value < size() ? blob_.data() + offsets_[value] : nullptr;
+    }
+
+    /**
+     * @return the length of the name of @p value, 0 if it is out of range
+     */
+    std::size_t name_size(value_type value) const noexcept
+    {
+        return value < size() ? offsets_[value + 1] - offsets_[value] - 1 : 0;
+    }
+
+    std::string to_string(value_type value) const
+    {
+        return value < size() ? std::string(name(value), name_size(value)) : std::string{};
+    }
+
+    /**
+     * @brief Parse the name in [first, last) without allocating.
+     * @return true and sets @p value if the range is exactly one of the names
+     */
+    bool from_chars(const char *first, const char *last, value_type &value) const noexcept
+    {
+        if (slots_.empty())
+        {
+            return false;
+        }
+        const std::size_t n = static_cast<std::size_t>(last - first);
+        const std::size_t mask = slots_.size() - 1;
+        for (std::size_t slot = enum_detail::hash_bytes(first, n) & mask; slots_[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const value_type i = slots_[slot] - 1;
+            if (name_size(i) == n && std::memcmp(name(i), first, n) == 0)
+            {
+                value = i;
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /**
+     * @brief Heap bytes held by the name blob, offset table and hash table.
+     */
+    std::size_t memory_bytes() const noexcept
+    {
+        return blob_.capacity() + (offsets_.capacity() + slots_.capacity()) * sizeof(std::uint32_t);
+    }
+
+private:
+    void add(const char *s, std::size_t n)
+    {
+        const std::size_t mask = slots_.size() - 1;
+        std::size_t slot = enum_detail::hash_bytes(s, n) & mask;
+        for (; slots_[slot] != 0; slot = (slot + 1) & mask)
+        {
+            const value_type i = slots_[slot] - 1;
+            if (name_size(i) == n && std::memcmp(name(i), s, n) == 0)
+            {
+                throw std::invalid_argument("RuntimeEnum: duplicate name '" + std::string(s, n) + "'");
+            }
+        }
+        blob_.append(s, n);
+        blob_.push_back('\0');
+        offsets_.push_back(static_cast<std::uint32_t>(blob_.size()));
+        slots_[slot] = static_cast<std::uint32_t>(offsets_.size() - 1);
+    }
+
+    std::string blob_;
+    std::vector<std::uint32_t> offsets_; // start of each name in blob_, then the end of the blob
+    std::vector<std::uint32_t> slots_;   // 1-based value, 0 for an empty slot
+};
+
+#endif // ENUM_RUNTIME_H
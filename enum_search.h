@@ -0,0 +1,450 @@
+#ifndef ENUM_SEARCH_H
+#define ENUM_SEARCH_H
+
+/**
+ * @file enum_search.h
+ */
+
+#include "enum.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace enum_detail
+{
+    template <std::size_t N, typename Names>
+    constexpr std::size_t total_length(const Names &names) noexcept
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            total += cstr_length(names[i]);
+        }
+        return total;
+    }
+
+    /// Number of distinct bytes used by @p names, plus one class for every other byte.
+    template <std::size_t N, typename Names>
+    constexpr std::size_t byte_class_count(const Names &names) noexcept
+    {
+        carray<bool, 256> used{};
+        std::size_t count = 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (const char *p = names[i]; *p != '\0'; ++p)
+            {
+                const auto b = static_cast<unsigned char>(*p);
+                count += used[b] ? 0 : 1;
+                used[b] = true;
+            }
+        }
+        return count;
+    }
+
+    /// Number of distinct first bytes of @p names, i.e. of children of the trie root.
+    template <std::size_t N, typename Names>
+    constexpr std::size_t first_byte_count(const Names &names) noexcept
+    {
+        carray<bool, 256> used{};
+        std::size_t count = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const auto b = static_cast<unsigned char>(names[i][0]);
+            count += b == 0 || used[b] ? 0 : 1;
+            used[b] = true;
+        }
+        return count;
+    }
+
+    /**
+     * @brief Number of states of the trie of @p names: the root plus one per distinct prefix.
+     * @param Capacity upper bound on the result, e.g. the total length of the names plus one
+     *
+     * The trie is built with child/sibling links, so the cost is linear in the
+     * total length of the names for small alphabets.
+     */
+    template <std::size_t N, std::size_t Capacity, typename Names>
+    constexpr std::size_t trie_state_count(const Names &names) noexcept
+    {
+        carray<std::uint32_t, Capacity> first_child{};
+        carray<std::uint32_t, Capacity> next_sibling{};
+        carray<char, Capacity> label{};
+        std::uint32_t states = 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            std::uint32_t s = 0;
+            for (const char *p = names[i]; *p != '\0'; ++p)
+            {
+                std::uint32_t c = first_child[s];
+                while (c != 0 && label[c] != *p)
+                {
+                    c = next_sibling[c];
+                }
+                if (c == 0)
+                {
+                    c = states++;
+                    label[c] = *p;
+                    next_sibling[c] = first_child[s];
+                    first_child[s] = c;
+                }
+                s = c;
+            }
+        }
+        return states;
+    }
+
+    /**
+     * @brief Aho-Corasick automaton over a fixed set of names, built in a constant expression.
+     * @param States number of trie states, from trie_state_count()
+     * @param Dense the root and its children, i.e. first_byte_count() + 1
+     *
+     * States are numbered breadth-first, so the children of a state are the
+     * contiguous range [first_child[s], first_child[s + 1]) and the root and
+     * its children are states 0 .. Dense - 1. Those shallow states, where a
+     * scan spends most of its time, have dense transition rows indexed by
+     * byte class with the failure links folded in: outside of a partial match
+     * a byte costs one table load. Deeper states search their few children and
+     * otherwise follow their failure link, which costs at most two transitions
+     * per byte amortized and keeps the automaton linear in the number of states
+     * rather than in states x byte classes.
+     *
+     * While at the root, the scan skips ahead to the next byte that starts a
+     * name: with SSE2 and at most @p max_vector_starts distinct first bytes,
+     * 16 bytes at a time, otherwise with a tight loop over the root row.
+     *
+     * Each state knows the name it completes, if any, and the next shorter
+     * matching suffix state. States and name indices are stored in the
+     * narrowest type that holds them. Names may repeat; all names equal to a
+     * completed one are chained in @p same.
+     */
+    template <std::size_t N, std::size_t States, std::size_t Classes, std::size_t Dense>
+    struct aho_corasick
+    {
+        using state_type = least_uint_t<States + 1>;
+        using name_type = least_uint_t<N + 1>;
+
+        static constexpr std::size_t max_vector_starts = 8;
+
+        carray<std::uint8_t, 256> byte_class;
+        carray<char, Dense> starts; // first bytes of the names, i.e. the labels of states 1 .. Dense - 1
+        carray<state_type, Dense * Classes> dense;
+        carray<state_type, States + 1> first_child;
+        carray<std::uint8_t, States> label; // byte class of the edge into the state
+        carray<state_type, States> fail;
+        carray<name_type, States> match;   // 1-based name index, 0 if none
+        carray<state_type, States> output; // next state on the suffix chain with a match, 0 if none
+        carray<name_type, N> same;         // 1-based index of the next equal name, 0 if none
+        carray<std::uint32_t, N> lengths;
+
+        /// State reached from @p s on a byte of class @p c.
+        constexpr std::size_t step(std::size_t s, std::size_t c) const noexcept
+        {
+            for (;;)
+            {
+                if (s < Dense)
+                {
+                    return dense[s * Classes + c];
+                }
+                for (std::size_t t = first_child[s]; t != first_child[s + 1]; ++t)
+                {
+                    if (label[t] == c)
+                    {
+                        return t;
+                    }
+                }
+                s = fail[s];
+            }
+        }
+
+        /// First position in [p, last) holding a byte that starts a name, or last.
+        const char *skip_to_start(const char *p, const char *last) const noexcept
+        {
+#if defined(__SSE2__)
+            if (Dense - 1 <= max_vector_starts)
+            {
+                __m128i needles[max_vector_starts];
+                for (std::size_t i = 0; i + 1 < Dense; ++i)
+                {
+                    needles[i] = _mm_set1_epi8(starts[i]);
+                }
+                while (last - p >= 16)
+                {
+                    const __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+                    __m128i hits = _mm_setzero_si128();
+                    for (std::size_t i = 0; i + 1 < Dense; ++i)
+                    {
+                        hits = _mm_or_si128(hits, _mm_cmpeq_epi8(v, needles[i]));
+                    }
+                    const int mask = _mm_movemask_epi8(hits);
+                    if (mask != 0)
+                    {
+                        return p + __builtin_ctz(static_cast<unsigned>(mask));
+                    }
+                    p += 16;
+                }
+            }
+#endif
+            while (p != last && dense[byte_class[static_cast<unsigned char>(*p)]] == 0)
+            {
+                ++p;
+            }
+            return p;
+        }
+
+        /// Call on_match(offset, index) for every occurrence of a name in [first, last).
+        template <typename F>
+        void scan(const char *first, const char *last, F &&on_match) const
+        {
+            // an empty name matches at the root, which then cannot be skipped
+            const bool skip = match[0] == 0;
+            std::size_t state = 0;
+            for (const char *p = first; p != last; ++p)
+            {
+                if (state == 0 && skip)
+                {
+                    p = skip_to_start(p, last);
+                    if (p == last)
+                    {
+                        break;
+                    }
+                }
+                state = step(state, byte_class[static_cast<unsigned char>(*p)]);
+                for (std::size_t s = match[state] != 0 ? state : output[state]; s != 0; s = output[s])
+                {
+                    for (std::size_t m = match[s]; m != 0; m = same[m - 1])
+                    {
+                        const std::size_t index = m - 1;
+                        on_match(static_cast<std::size_t>(p + 1 - first) - lengths[index], index);
+                    }
+                }
+            }
+        }
+    };
+
+    template <std::size_t States, std::size_t Classes, std::size_t Dense, std::size_t N, typename Names>
+    constexpr aho_corasick<N, States, Classes, Dense> make_aho_corasick(const Names &names) noexcept
+    {
+        using automaton = aho_corasick<N, States, Classes, Dense>;
+        using state_type = typename automaton::state_type;
+        using name_type = typename automaton::name_type;
+        automaton ac{};
+
+        std::size_t classes = 1;
+        carray<char, Classes> class_byte{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            for (const char *p = names[i]; *p != '\0'; ++p)
+            {
+                auto &c = ac.byte_class[static_cast<unsigned char>(*p)];
+                if (c == 0)
+                {
+                    class_byte[classes] = *p;
+                    c = static_cast<std::uint8_t>(classes++);
+                }
+            }
+        }
+
+        // trie with child/sibling links, in insertion order; node 0 is the root
+        carray<state_type, States> child{};
+        carray<state_type, States> sibling{};
+        carray<std::uint8_t, States> edge{};
+        carray<name_type, States> completes{};
+        std::size_t nodes = 1;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            std::size_t s = 0;
+            for (const char *p = names[i]; *p != '\0'; ++p)
+            {
+                const std::uint8_t c = ac.byte_class[static_cast<unsigned char>(*p)];
+                std::size_t t = child[s];
+                while (t != 0 && edge[t] != c)
+                {
+                    t = sibling[t];
+                }
+                if (t == 0)
+                {
+                    t = nodes++;
+                    edge[t] = c;
+                    sibling[t] = child[s];
+                    child[s] = static_cast<state_type>(t);
+                }
+                s = t;
+            }
+            // keep equal names in declaration order
+            name_type *last = &completes[s];
+            while (*last != 0)
+            {
+                last = &ac.same[*last - 1];
+            }
+            *last = static_cast<name_type>(i + 1);
+            ac.lengths[i] = static_cast<std::uint32_t>(cstr_length(names[i]));
+        }
+
+        // renumber breadth-first; node_of[] doubles as the queue
+        carray<state_type, States> node_of{};
+        std::size_t numbered = 1;
+        for (std::size_t s = 0; s < States; ++s)
+        {
+            const std::size_t u = node_of[s];
+            ac.match[s] = completes[u];
+            ac.first_child[s] = static_cast<state_type>(numbered);
+            for (std::size_t v = child[u]; v != 0; v = sibling[v])
+            {
+                ac.label[numbered] = edge[v];
+                node_of[numbered++] = static_cast<state_type>(v);
+            }
+        }
+        ac.first_child[States] = static_cast<state_type>(States);
+        for (std::size_t t = 1; t < Dense; ++t)
+        {
+            ac.starts[t - 1] = class_byte[ac.label[t]];
+        }
+
+        // breadth-first: failure links, output links and the dense rows
+        for (std::size_t s = 0; s < States; ++s)
+        {
+            if (s < Dense)
+            {
+                for (std::size_t c = 0; c < Classes; ++c)
+                {
+                    ac.dense[s * Classes + c] = s == 0 ? 0 : ac.dense[ac.fail[s] * Classes + c];
+                }
+                for (std::size_t t = ac.first_child[s]; t != ac.first_child[s + 1]; ++t)
+                {
+                    ac.dense[s * Classes + ac.label[t]] = static_cast<state_type>(t);
+                }
+            }
+            for (std::size_t t = ac.first_child[s]; t != ac.first_child[s + 1]; ++t)
+            {
+                const std::size_t f = s == 0 ? 0 : ac.step(ac.fail[s], ac.label[t]);
+                ac.fail[t] = static_cast<state_type>(f);
+                ac.output[t] = ac.match[f] != 0 ? static_cast<state_type>(f) : ac.output[f];
+            }
+        }
+        return ac;
+    }
+
+    template <std::size_t N, std::size_t States, std::size_t Classes, std::size_t Dense>
+    constexpr std::size_t aho_corasick<N, States, Classes, Dense>::max_vector_starts;
+
+    template <std::size_t N>
+    constexpr std::size_t sum(const std::array<std::size_t, N> &values) noexcept
+    {
+        std::size_t total = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            total += values[i];
+        }
+        return total;
+    }
+
+    template <typename... Es>
+    constexpr std::size_t joined_count() noexcept
+    {
+        return sum(std::array<std::size_t, sizeof...(Es)>{{enum_count<Es>()...}});
+    }
+
+    template <std::size_t Total, std::size_t N>
+    constexpr std::size_t append_names(carray<const char *, Total> &all, std::size_t pos,
+                                       const std::array<const char *, N> &names) noexcept
+    {
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            all[pos++] = names[i];
+        }
+        return pos;
+    }
+
+    /// Names of all of @p Es, one enumeration after the other.
+    template <typename... Es>
+    constexpr carray<const char *, joined_count<Es...>()> joined_names() noexcept
+    {
+        carray<const char *, joined_count<Es...>()> all{};
+        std::size_t pos = 0;
+        const std::size_t ends[] = {(pos = append_names(all, pos, EnumMetaInfo<Es>::Names()))...};
+        static_cast<void>(ends);
+        return all;
+    }
+
+    template <typename E, typename F>
+    void deliver_match(F &f, std::size_t offset, std::size_t index)
+    {
+        f(offset, static_cast<E>(index));
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Compile-time Aho-Corasick automaton over the names of @p E.
+ */
+template <typename E>
+const auto &enum_matcher() noexcept
+{
+    constexpr std::size_t n = enum_count<E>();
+    constexpr auto names = EnumMetaInfo<E>::Names();
+    constexpr std::size_t states = enum_detail::trie_state_count<n, enum_detail::total_length<n>(names) + 1>(names);
+    static constexpr auto matcher =
+        enum_detail::make_aho_corasick<states, enum_detail::byte_class_count<n>(names),
+                                       enum_detail::first_byte_count<n>(names) + 1, n>(names);
+    return matcher;
+}
+
+/**
+ * @brief Find every occurrence of a name of @p E in [first, last) in a single pass.
+ * @param on_match called as on_match(offset, e) for each match, in order of match end
+ *
+ * Overlapping and nested occurrences are all reported; names are matched as
+ * substrings, without regard to word boundaries.
+ */
+template <typename E, typename F>
+void enum_find_all(const char *first, const char *last, F &&on_match)
+{
+    enum_matcher<E>().scan(first, last, [&](std::size_t offset, std::size_t index) {
+        on_match(offset, static_cast<E>(index));
+    });
+}
+
+/**
+ * @brief Find every occurrence of a name of any of @p E1, @p E2, @p Es... in [first, last) in a single pass.
+ * @param on_match called as on_match(offset, e) for each match, with e of the enumeration the name belongs to,
+ *        so it is typically a generic lambda or an overload set
+ *
+ * The names of all enumerations share one automaton. A string that names
+ * enumerators of several of the types is reported once per type, in the
+ * order the types are given.
+ */
+template <typename E1, typename E2, typename... Es, typename F>
+void enum_find_all(const char *first, const char *last, F &&on_match)
+{
+    constexpr std::size_t n = enum_detail::joined_count<E1, E2, Es...>();
+    constexpr auto names = enum_detail::joined_names<E1, E2, Es...>();
+    constexpr std::size_t states = enum_detail::trie_state_count<n, enum_detail::total_length<n>(names) + 1>(names);
+    static constexpr auto matcher =
+        enum_detail::make_aho_corasick<states, enum_detail::byte_class_count<n>(names),
+                                       enum_detail::first_byte_count<n>(names) + 1, n>(names);
+    static constexpr std::size_t counts[] = {enum_count<E1>(), enum_count<E2>(), enum_count<Es>()...};
+    using deliver = void (*)(F &, std::size_t, std::size_t);
+    static constexpr deliver table[] = {&enum_detail::deliver_match<E1, F>, &enum_detail::deliver_match<E2, F>,
+                                        &enum_detail::deliver_match<Es, F>...};
+    matcher.scan(first, last, [&](std::size_t offset, std::size_t index) {
+        std::size_t type = 0;
+        while (index >= counts[type])
+        {
+            index -= counts[type++];
+        }
+        table[type](on_match, offset, index);
+    });
+}
+
+/**
+ * @brief Offsets and values of every occurrence of a name of @p E in [first, last).
+ */
+template <typename E>
+std::vector<std::pair<std::size_t, E>> enum_find_all(const char *first, const char *last)
+{
+    std::vector<std::pair<std::size_t, E>> matches;
+    enum_find_all<E>(first, last, [&](std::size_t offset, E e) { matches.emplace_back(offset, e); });
+    return matches;
+}
+
+#endif // ENUM_SEARCH_H
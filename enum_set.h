@@ -0,0 +1,295 @@
+#ifndef ENUM_SET_H
+#define ENUM_SET_H
+
+/**
+ * @file enum_set.h
+ */
+
+#include "enum.h"
+
+#include <atomic>
+#include <ostream>
+#include <thread>
+
+/**
+ * @brief Set of values of @p E packed one bit per enumerator.
+ */
+template <typename E>
+class EnumSet
+{
+public:
+    static constexpr std::size_t word_count = enum_detail::bit_words(enum_count<E>());
+    using words_type = std::array<std::uint64_t, word_count>;
+
+    constexpr EnumSet() noexcept : words_{} {}
+    explicit constexpr EnumSet(const words_type &words) noexcept : words_(words) {}
+
+    bool test(E e) const noexcept
+    {
+        const std::size_t i = enum_index(e);
+        return i < enum_count<E>() && (words_[i / 64] >> (i % 64) & 1) != 0;
+    }
+
+    void insert(E e) noexcept
+    {
+        const std::size_t i = enum_index(e);
+        if (i < enum_count<E>())
+        {
+            words_[i / 64] |= std::uint64_t{1} << (i % 64);
+        }
+    }
+
+    void erase(E e) noexcept
+    {
+        const std::size_t i = enum_index(e);
+        if (i < enum_count<E>())
+        {
+            words_[i / 64] &= ~(std::uint64_t{1} << (i % 64));
+        }
+    }
+
+    std::size_t size() const noexcept
+    {
+        std::size_t n = 0;
+        for (std::uint64_t word : words_)
+        {
+            n += enum_detail::popcount64(word);
+        }
+        return n;
+    }
+
+    /**
+     * @brief Call f(e) for every member, in index order.
+     */
+    template <typename F>
+    void for_each(F &&f) const
+    {
+        for (std::size_t w = 0; w < word_count; ++w)
+        {
+            for (std::uint64_t word = words_[w]; word != 0; word &= word - 1)
+            {
+                f(static_cast<E>(w * 64 + enum_detail::countr_zero64(word)));
+            }
+        }
+    }
+
+    const words_type &words() const noexcept
+    {
+        return words_;
+    }
+
+    /// Union.
+    EnumSet &operator|=(const EnumSet &other) noexcept
+    {
+        for (std::size_t w = 0; w < word_count; ++w)
+        {
+            words_[w] |= other.words_[w];
+        }
+        return *this;
+    }
+
+    /// Intersection.
+    EnumSet &operator&=(const EnumSet &other) noexcept
+    {
+        for (std::size_t w = 0; w < word_count; ++w)
+        {
+            words_[w] &= other.words_[w];
+        }
+        return *this;
+    }
+
+    /// Difference: the members not in @p other.
+    EnumSet &operator-=(const EnumSet &other) noexcept
+    {
+        for (std::size_t w = 0; w < word_count; ++w)
+        {
+            words_[w] &= ~other.words_[w];
+        }
+        return *this;
+    }
+
+    friend EnumSet operator|(EnumSet a, const EnumSet &b) noexcept
+    {
+        return a |= b;
+    }
+
+    friend EnumSet operator&(EnumSet a, const EnumSet &b) noexcept
+    {
+        return a &= b;
+    }
+
+    friend EnumSet operator-(EnumSet a, const EnumSet &b) noexcept
+    {
+        return a -= b;
+    }
+
+    friend bool operator==(const EnumSet &a, const EnumSet &b) noexcept
+    {
+        return a.words_ == b.words_;
+    }
+
+    friend bool operator!=(const EnumSet &a, const EnumSet &b) noexcept
+    {
+        return !(a == b);
+    }
+
+    /// Formats as `{NAME, NAME}`.
+    friend std::ostream &operator<<(std::ostream &os, const EnumSet &set)
+    {
+        os << '{';
+        const char *separator = "";
+        set.for_each([&](E e) {
+            os << separator;
+            os.write(enum_name(e), static_cast<std::streamsize>(enum_name_size(e)));
+            separator = ", ";
+        });
+        return os << '}';
+    }
+
+private:
+    words_type words_;
+};
+
+template <typename E>
+constexpr std::size_t EnumSet<E>::word_count;
+
+/**
+ * @brief Lock-free set of values of @p E for concurrent flag updates.
+ *
+ * insert() and erase() are a single fetch_or / fetch_and on the word holding
+ * the enumerator, and test() a single load. When the set spans several
+ * words, each update is bracketed by a sequence word counting the writers in
+ * progress (low half) and the completed updates (high half), and snapshot()
+ * is a seqlock read: it only accepts words read while no writer was in
+ * progress and no update completed, which gives a state the set was actually
+ * in even when one writer reacts to another's update.
+ *
+ * The price for multi-word sets is two extra read-modify-writes per update
+ * on the one sequence word, which all writers contend on; it sits on its own
+ * cache line so that it does not also slow down test(). Snapshots are not
+ * lock-free: a writer preempted between its two sequence updates holds back
+ * every snapshot until it resumes, and continuous writes can delay them, so
+ * snapshot() yields between retries. Single-word sets need none of this.
+ *
+ * Allocate multi-word sets with static storage duration or aligned storage,
+ * since C++14 operator new ignores the over-alignment of the sequence word.
+ */
+template <typename E>
+class AtomicEnumSet
+{
+public:
+    static constexpr std::size_t word_count = EnumSet<E>::word_count;
+
+    AtomicEnumSet() noexcept
+    {
+        for (auto &word : words_)
+        {
+            word.store(0, std::memory_order_relaxed);
+        }
+    }
+
+    AtomicEnumSet(const AtomicEnumSet &) = delete;
+    AtomicEnumSet &operator=(const AtomicEnumSet &) = delete;
+
+    /**
+     * @return true if @p e was not a member before
+     */
+    bool insert(E e) noexcept
+    {
+        const std::size_t i = enum_index(e);
+        if (i >= enum_count<E>())
+        {
+            return false;
+        }
+        const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+        begin_update();
+        const bool inserted = (words_[i / 64].fetch_or(bit) & bit) == 0;
+        end_update();
+        return inserted;
+    }
+
+    /**
+     * @return true if @p e was a member before
+     */
+    bool erase(E e) noexcept
+    {
+        const std::size_t i = enum_index(e);
+        if (i >= enum_count<E>())
+        {
+            return false;
+        }
+        const std::uint64_t bit = std::uint64_t{1} << (i % 64);
+        begin_update();
+        const bool erased = (words_[i / 64].fetch_and(~bit) & bit) != 0;
+        end_update();
+        return erased;
+    }
+
+    bool test(E e) const noexcept
+    {
+        const std::size_t i = enum_index(e);
+        return i < enum_count<E>() && (words_[i / 64].load() >> (i % 64) & 1) != 0;
+    }
+
+    EnumSet<E> snapshot() const noexcept
+    {
+        typename EnumSet<E>::words_type words{};
+        for (unsigned attempt = 0;; ++attempt)
+        {
+            if (attempt >= spins_before_yield)
+            {
+                std::this_thread::yield();
+            }
+            const std::uint64_t before = word_count > 1 ? sequence_.load() : 0;
+            if ((before & writers_mask) != 0)
+            {
+                continue;
+            }
+            for (std::size_t w = 0; w < word_count; ++w)
+            {
+                words[w] = words_[w].load();
+            }
+            if (word_count <= 1 || sequence_.load() == before)
+            {
+                return EnumSet<E>(words);
+            }
+        }
+    }
+
+private:
+    static constexpr std::uint64_t writers_mask = 0xffffffff;
+    static constexpr unsigned spins_before_yield = 64;
+
+    void begin_update() noexcept
+    {
+        if (word_count > 1)
+        {
+            sequence_.fetch_add(1);
+        }
+    }
+
+    /// Leaves the writer count and bumps the completed count in one step.
+    void end_update() noexcept
+    {
+        if (word_count > 1)
+        {
+            sequence_.fetch_add(writers_mask);
+        }
+    }
+
+    std::atomic<std::uint64_t> words_[word_count > 0 ? word_count : 1];
+    // on its own cache line only when it is used
+    alignas(word_count > 1 ? enum_detail::cache_line_size : alignof(std::atomic<std::uint64_t>))
+        std::atomic<std::uint64_t> sequence_{0};
+};
+
+template <typename E>
+constexpr std::size_t AtomicEnumSet<E>::word_count;
+
+template <typename E>
+constexpr std::uint64_t AtomicEnumSet<E>::writers_mask;
+
+template <typename E>
+constexpr unsigned AtomicEnumSet<E>::spins_before_yield;
+
+#endif // ENUM_SET_H
@@ -0,0 +1,147 @@
+#ifndef ENUM_STATE_H
+#define ENUM_STATE_H
+
+/**
+ * @file enum_state.h
+ */
+
+#include "enum.h"
+
+#include <atomic>
+
+/**
+ * @brief An allowed transition, given by enumerator names.
+ */
+struct EnumTransition
+{
+    const char *from;
+    const char *to;
+};
+
+/**
+ * @brief Dense N x N bit matrix of the allowed transitions between values of @p E.
+ *
+ * Row `from` holds one bit per target state, so a check is a single bit test.
+ */
+template <typename E>
+struct EnumTransitionTable
+{
+    static constexpr std::size_t row_words = enum_detail::bit_words(enum_count<E>());
+
+    enum_detail::carray<std::uint64_t, enum_count<E>() * row_words> bits;
+
+    constexpr bool allowed(E from, E to) const noexcept
+    {
+        const std::size_t i = enum_index(from);
+        const std::size_t j = enum_index(to);
+        return i < enum_count<E>() && j < enum_count<E>() && (bits[i * row_words + j / 64] >> (j % 64) & 1) != 0;
+    }
+};
+
+namespace enum_detail
+{
+    template <typename E>
+    constexpr std::size_t index_of_name(const char *name)
+    {
+        const auto names = EnumMetaInfo<E>::Names();
+        const std::size_t n = cstr_length(name);
+        for (std::size_t i = 0; i < names.size(); ++i)
+        {
+            if (cstr_length(names[i]) == n && equal_bytes(names[i], name, n))
+            {
+                return i;
+            }
+        }
+        throw std::invalid_argument("unknown enumerator name in transition table");
+    }
+
+    /// Names are only formatted here, on the error path.
+    template <typename E>
+    [[noreturn]] void throw_invalid_transition(E from, E to)
+    {
+        const char *from_name = enum_name(from);
+        const char *to_name = enum_name(to);
+        throw std::logic_error(std::string("invalid transition ") + (from_name != nullptr ? from_name : "?") +
+                               " -> " + (to_name != nullptr ? to_name : "?"));
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Build the transition matrix of @p E from pairs of names.
+ *
+ * Names are resolved against the ENUM_STRINGS table of @p E. When the result
+ * initializes a constexpr variable, an unknown name is a compile-time error.
+ */
+template <typename E, std::size_t N>
+constexpr EnumTransitionTable<E> make_enum_transitions(const EnumTransition (&transitions)[N])
+{
+    EnumTransitionTable<E> table{};
+    for (std::size_t k = 0; k < N; ++k)
+    {
+        const std::size_t i = enum_detail::index_of_name<E>(transitions[k].from);
+        const std::size_t j = enum_detail::index_of_name<E>(transitions[k].to);
+        table.bits[i * EnumTransitionTable<E>::row_words + j / 64] |= std::uint64_t{1} << (j % 64);
+    }
+    return table;
+}
+
+/**
+ * @brief Atomic holder of a state of @p E that only moves along allowed transitions.
+ *
+ * The transition table must outlive the holder; a constexpr table at
+ * namespace scope is the intended use.
+ */
+template <typename E>
+class AtomicEnumState
+{
+public:
+    AtomicEnumState(const EnumTransitionTable<E> &table, E initial) noexcept
+        : table_(&table), state_(static_cast<base_type>(initial))
+    {
+    }
+
+    E load(std::memory_order order = std::memory_order_seq_cst) const noexcept
+    {
+        return static_cast<E>(state_.load(order));
+    }
+
+    /**
+     * @brief Move from @p from to @p to with a single compare-exchange.
+     * @return false if the transition is not allowed or the current state is not @p from
+     */
+    bool try_transition(E from, E to) noexcept
+    {
+        if (!table_->allowed(from, to))
+        {
+            return false;
+        }
+        auto expected = static_cast<base_type>(from);
+        return state_.compare_exchange_strong(expected, static_cast<base_type>(to));
+    }
+
+    /**
+     * @brief Move from the current state to @p to.
+     * @return the state that was left
+     * @throws std::logic_error naming both states if the transition is not allowed
+     */
+    E transition(E to)
+    {
+        auto current = state_.load(std::memory_order_relaxed);
+        do
+        {
+            if (!table_->allowed(static_cast<E>(current), to))
+            {
+                enum_detail::throw_invalid_transition(static_cast<E>(current), to);
+            }
+        } while (!state_.compare_exchange_weak(current, static_cast<base_type>(to)));
+        return static_cast<E>(current);
+    }
+
+private:
+    using base_type = std::underlying_type_t<E>;
+
+    const EnumTransitionTable<E> *table_;
+    std::atomic<base_type> state_;
+};
+
+#endif // ENUM_STATE_H
@@ -0,0 +1,190 @@
+#ifndef ENUM_STREAM_H
+#define ENUM_STREAM_H
+
+/**
+ * @file enum_stream.h
+ */
+
+#include "enum.h"
+
+#include <cstring>
+#include <istream>
+#include <iterator>
+#include <memory>
+#include <ostream>
+
+/**
+ * @brief Write the names of [first, last) separated by @p delimiter.
+ *
+ * Names are copied from the static name table into a stack buffer that is
+ * handed to the stream buffer with one sputn() per 4 KiB, bypassing the
+ * per-element formatting of operator<<. A value without a name sets
+ * failbit and stops writing after the names before it, since it could not
+ * be read back.
+ */
+template <typename E>
+std::ostream &enum_write_range(std::ostream &os, const E *first, const E *last, char delimiter = ' ')
+{
+    const std::ostream::sentry sentry(os);
+    if (!sentry)
+    {
+        return os;
+    }
+    char buffer[4096];
+    std::size_t used = 0;
+    const auto write = [&os](const char *data, std::size_t n) {
+        if (os.rdbuf()->sputn(data, static_cast<std::streamsize>(n)) != static_cast<std::streamsize>(n))
+        {
+            os.setstate(std::ios_base::badbit);
+        }
+    };
+    const auto flush = [&] {
+        write(buffer, used);
+        used = 0;
+    };
+    for (const E *p = first; p != last && os; ++p)
+    {
+        const char *name = enum_name(*p);
+        if (name == nullptr)
+        {
+            flush();
+            os.setstate(std::ios_base::failbit);
+            break;
+        }
+        const std::size_t n = enum_name_size(*p);
+        if (used + n + 1 > sizeof(buffer))
+        {
+            flush();
+        }
+        if (p != first)
+        {
+            buffer[used++] = delimiter;
+        }
+        if (n + 1 > sizeof(buffer))
+        {
+            // longer than the buffer: write it directly
+            flush();
+            write(name, n);
+            continue;
+        }
+        std::memcpy(buffer + used, name, n);
+        used += n;
+    }
+    if (used > 0 && os)
+    {
+        flush();
+    }
+    return os;
+}
+
+/**
+ * @brief Read names separated by whitespace or @p delimiter until end of input, appending values to @p out.
+ *
+ * Tokens are accumulated straight from the stream buffer into a buffer no
+ * longer than the longest name, without a std::string per element. An
+ * unknown name sets failbit and stops reading after it; reaching the end of
+ * input sets eofbit only. Whitespace around names is skipped, but when
+ * @p delimiter is not whitespace an empty field (a leading or trailing
+ * delimiter, or two with only whitespace between them) also sets failbit,
+ * so that a range read back has as many elements as were written.
+ */
+template <typename E, typename OutputIt>
+std::istream &enum_read_range(std::istream &is, OutputIt out, char delimiter = ' ')
+{
+    const std::istream::sentry sentry(is, true);
+    if (!sentry)
+    {
+        return is;
+    }
+    std::streambuf *buf = is.rdbuf();
+    const std::size_t capacity = enum_max_name_size<E>() + 1;
+    char stack_token[64];
+    std::unique_ptr<char[]> heap_token(capacity > sizeof(stack_token) ? new char[capacity] : nullptr);
+    char *token = heap_token ? heap_token.get() : stack_token;
+    const auto is_space = [](int c) {
+        return c == ' ' || c == '\n' || c == '\t' || c == '\r' || c == '\v' || c == '\f';
+    };
+    const auto is_separator = [&](int c) { return c == delimiter || is_space(c); };
+    const bool counts_fields = !is_space(delimiter);
+    bool after_name = false; // a name was read since the last delimiter
+    bool pending = false;    // a delimiter was read and no name followed yet
+    constexpr auto eof = std::char_traits<char>::eof();
+    int c = buf->sgetc();
+    for (;;)
+    {
+        while (c != eof && is_separator(c))
+        {
+            if (counts_fields && c == delimiter)
+            {
+                if (!after_name)
+                {
+                    is.setstate(std::ios_base::failbit);
+                    return is;
+                }
+                after_name = false;
+                pending = true;
+            }
+            c = buf->snextc();
+        }
+        if (c == eof)
+        {
+            is.setstate(pending ? std::ios_base::eofbit | std::ios_base::failbit : std::ios_base::eofbit);
+            break;
+        }
+        std::size_t n = 0;
+        while (c != eof && !is_separator(c))
+        {
+            if (n < capacity)
+            {
+                token[n] = static_cast<char>(c);
+            }
+            ++n;
+            c = buf->snextc();
+        }
+        E e{};
+        if (n >= capacity || !enum_from_chars(token, token + n, e))
+        {
+            is.setstate(std::ios_base::failbit);
+            break;
+        }
+        *out++ = e;
+        after_name = true;
+        pending = false;
+    }
+    return is;
+}
+
+/**
+ * @brief Stream adaptor of a container of enumerators for the range functions above.
+ *
+ * `os << enum_range(v)` writes all elements, `is >> enum_range(v)` appends
+ * the elements read to @p v.
+ */
+template <typename Container>
+struct EnumRange
+{
+    Container &container;
+    char delimiter;
+};
+
+template <typename Container>
+EnumRange<Container> enum_range(Container &container, char delimiter = ' ') noexcept
+{
+    return EnumRange<Container>{container, delimiter};
+}
+
+template <typename Container>
+std::ostream &operator<<(std::ostream &os, const EnumRange<Container> &range)
+{
+    const auto *data = range.container.data();
+    return enum_write_range(os, data, data + range.container.size(), range.delimiter);
+}
+
+template <typename Container>
+std::istream &operator>>(std::istream &is, const EnumRange<Container> &range)
+{
+    using value_type = typename std::remove_const_t<Container>::value_type;
+    return enum_read_range<value_type>(is, std::back_inserter(range.container), range.delimiter);
+}
+
+#endif // ENUM_STREAM_H
@@ -0,0 +1,211 @@
+#ifndef ENUM_SUGGEST_H
+#define ENUM_SUGGEST_H
+
+/**
+ * @file enum_suggest.h
+ */
+
+#include "enum.h"
+
+#include <algorithm>
+
+namespace enum_detail
+{
+    template <std::size_t N>
+    constexpr std::size_t max_name_length(const std::array<const char *, N> &names) noexcept
+    {
+        std::size_t max = 0;
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            max = cstr_length(names[i]) > max ? cstr_length(names[i]) : max;
+        }
+        return max;
+    }
+
+    constexpr std::uint64_t char_signature(const char *s, std::size_t n) noexcept
+    {
+        std::uint64_t signature = 0;
+        for (std::size_t i = 0; i < n; ++i)
+        {
+            signature |= std::uint64_t{1} << (static_cast<unsigned char>(s[i]) & 63);
+        }
+        return signature;
+    }
+
+    /**
+     * @brief Names bucketed by length, with a 64-bit character signature each.
+     *
+     * Names of length l are order[by_length[l]] .. order[by_length[l + 1] - 1].
+     * An edit changes at most two bits of the signature, which gives a cheap
+     * lower bound on the distance before the exact computation.
+     */
+    template <std::size_t N, std::size_t MaxLength>
+    struct suggestion_index
+    {
+        carray<std::uint32_t, N> order;
+        carray<std::uint32_t, MaxLength + 2> by_length;
+        carray<std::uint64_t, N> signatures;
+        carray<std::uint32_t, N> lengths;
+    };
+
+    template <std::size_t MaxLength, std::size_t N>
+    constexpr suggestion_index<N, MaxLength> make_suggestion_index(const std::array<const char *, N> &names) noexcept
+    {
+        suggestion_index<N, MaxLength> index{};
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            const std::size_t n = cstr_length(names[i]);
+            index.lengths[i] = static_cast<std::uint32_t>(n);
+            index.signatures[i] = char_signature(names[i], n);
+            ++index.by_length[n + 1];
+        }
+        for (std::size_t l = 1; l < MaxLength + 2; ++l)
+        {
+            index.by_length[l] += index.by_length[l - 1];
+        }
+        carray<std::uint32_t, MaxLength + 1> next{};
+        for (std::size_t l = 0; l <= MaxLength; ++l)
+        {
+            next[l] = index.by_length[l];
+        }
+        for (std::size_t i = 0; i < N; ++i)
+        {
+            index.order[next[index.lengths[i]]++] = static_cast<std::uint32_t>(i);
+        }
+        return index;
+    }
+
+    /**
+     * @brief Levenshtein distance with Myers' bit-parallel algorithm, the pattern being at most 64 bytes.
+     * @return the distance, or any value above @p bound once it is certain to exceed it
+     */
+    inline std::size_t bit_parallel_distance(const std::uint64_t (&peq)[256], std::size_t m, const char *text,
+                                             std::size_t n, std::size_t bound) noexcept
+    {
+        const std::uint64_t last = std::uint64_t{1} << (m - 1);
+        std::uint64_t pv = m == 64 ? ~std::uint64_t{0} : (std::uint64_t{1} << m) - 1;
+        std::uint64_t mv = 0;
+        std::size_t score = m;
+        for (std::size_t j = 0; j < n; ++j)
+        {
+            const std::uint64_t eq = peq[static_cast<unsigned char>(text[j])];
+            const std::uint64_t xv = eq | mv;
+            const std::uint64_t xh = (((eq & pv) + pv) ^ pv) | eq;
+            std::uint64_t ph = mv | ~(xh | pv);
+            std::uint64_t mh = pv & xh;
+            if ((ph & last) != 0)
+            {
+                ++score;
+            }
+            else if ((mh & last) != 0)
+            {
+                --score;
+            }
+            // the score can drop by at most one per remaining text byte
+            if (score > bound + (n - j - 1))
+            {
+                return bound + 1;
+            }
+            ph = (ph << 1) | 1;
+            mh <<= 1;
+            pv = mh | ~(xv | ph);
+            mv = ph & xv;
+        }
+        return score;
+    }
+
+    /// Plain dynamic-programming distance, for queries longer than 64 bytes.
+    inline std::size_t dp_distance(const char *a, std::size_t m, const char *b, std::size_t n)
+    {
+        std::vector<std::size_t> row(m + 1);
+        for (std::size_t i = 0; i <= m; ++i)
+        {
+            row[i] = i;
+        }
+        for (std::size_t j = 1; j <= n; ++j)
+        {
+            std::size_t diagonal = row[0];
+            row[0] = j;
+            for (std::size_t i = 1; i <= m; ++i)
+            {
+                const std::size_t above = row[i];
+                row[i] = std::min(std::min(row[i] + 1, row[i - 1] + 1), diagonal + (a[i - 1] != b[j - 1] ? 1 : 0));
+                diagonal = above;
+            }
+        }
+        return row[m];
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Closest name of @p E to the misspelled [first, last), for "did you mean" messages.
+ * @param max_distance largest Levenshtein distance worth suggesting
+ * @return true and sets @p suggestion if some name is within @p max_distance;
+ *         ties go to the shorter name, then to the enumerator declared first
+ *
+ * Only names whose length is within @p max_distance of the query are
+ * considered, and most of them are rejected by a character-signature check
+ * before a bit-parallel distance computation that stops early once the
+ * distance exceeds the best found so far.
+ */
+template <typename E>
+bool enum_suggest(const char *first, const char *last, E &suggestion, std::size_t max_distance = 2)
+{
+    constexpr auto names = EnumMetaInfo<E>::Names();
+    constexpr std::size_t max_length = enum_detail::max_name_length(names);
+    static constexpr auto index = enum_detail::make_suggestion_index<max_length>(names);
+    const auto &name_index = enum_name_index<E>();
+
+    const std::size_t m = static_cast<std::size_t>(last - first);
+    const std::uint64_t signature = enum_detail::char_signature(first, m);
+    std::uint64_t peq[256] = {};
+    for (std::size_t i = 0; i < m && m <= 64; ++i)
+    {
+        peq[static_cast<unsigned char>(first[i])] |= std::uint64_t{1} << i;
+    }
+
+    std::size_t best = max_distance + 1;
+    std::size_t best_index = enum_count<E>();
+    const std::size_t min_l = m > max_distance ? m - max_distance : 0;
+    const std::size_t max_l = std::min(m + max_distance, max_length);
+    for (std::size_t l = min_l; l <= max_l; ++l)
+    {
+        for (std::size_t k = index.by_length[l]; k < index.by_length[l + 1]; ++k)
+        {
+            const std::size_t i = index.order[k];
+            const std::size_t length_gap = l > m ? l - m : m - l;
+            const auto signature_gap = enum_detail::popcount64(signature ^ index.signatures[i]);
+            if (length_gap >= best || (signature_gap + 1) / 2 >= best)
+            {
+                continue;
+            }
+            const std::size_t bound = best - 1;
+            std::size_t d = 0;
+            if (m == 0)
+            {
+                d = l;
+            }
+            else if (m <= 64)
+            {
+                d = enum_detail::bit_parallel_distance(peq, m, name_index.names[i], l, bound);
+            }
+            else
+            {
+                d = enum_detail::dp_distance(first, m, name_index.names[i], l);
+            }
+            if (d < best)
+            {
+                best = d;
+                best_index = i;
+            }
+        }
+    }
+    if (best_index == enum_count<E>())
+    {
+        return false;
+    }
+    suggestion = static_cast<E>(best_index);
+    return true;
+}
+
+#endif // ENUM_SUGGEST_H
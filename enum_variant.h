@@ -0,0 +1,277 @@
+#ifndef ENUM_VARIANT_H
+#define ENUM_VARIANT_H
+
+/**
+ * @file enum_variant.h
+ */
+
+#include "enum.h"
+
+#include <new>
+#include <ostream>
+#include <tuple>
+
+namespace enum_detail
+{
+    template <std::size_t... Ns>
+    struct max_of;
+
+    template <>
+    struct max_of<> : std::integral_constant<std::size_t, 1>
+    {
+    };
+
+    template <std::size_t N, std::size_t... Ns>
+    struct max_of<N, Ns...> : std::integral_constant<std::size_t, (N > max_of<Ns...>::value ? N : max_of<Ns...>::value)>
+    {
+    };
+
+    template <bool... Bs>
+    struct bool_pack;
+
+    /// True if every one of @p Bs is.
+    template <bool... Bs>
+    using all_of = std::is_same<bool_pack<Bs..., true>, bool_pack<true, Bs...>>;
+
+    template <typename T, typename = void>
+    struct is_streamable : std::false_type
+    {
+    };
+
+    template <typename T>
+    struct is_streamable<T, decltype(void(std::declval<std::ostream &>() << std::declval<const T &>()))>
+        : std::true_type
+    {
+    };
+
+    template <typename T>
+    void print_alternative(std::ostream &os, const T &value, std::true_type)
+    {
+        os << '(' << value << ')';
+    }
+
+    template <typename T>
+    void print_alternative(std::ostream &, const T &, std::false_type)
+    {
+    }
+} // namespace enum_detail
+
+/**
+ * @brief Tagged union whose discriminant is a value of @p E.
+ * @param E the enumeration type (registered with ENUM_STRINGS)
+ * @param Ts one alternative per enumerator, in enumerator order
+ *
+ * The tag is stored in the narrowest unsigned type that can hold
+ * enum_count<E>() values, after the storage. Padding still rounds the size
+ * up to the strictest alignment, so a variant whose largest alternative T is
+ * also the most aligned takes sizeof(T) + alignof(T) bytes. visit()
+ * dispatches through a flat table of function pointers indexed by the tag. Streaming a variant prints the
+ * name of the active enumerator, followed by `(value)` if that alternative
+ * is itself streamable.
+ *
+ * Alternatives must be nothrow-move-constructible. New values are built
+ * aside and then moved into the storage, so assignment and emplace() leave
+ * the variant unchanged if construction throws, and moving a variant never
+ * throws.
+ */
+template <typename E, typename... Ts>
+class EnumVariant
+{
+    static_assert(sizeof...(Ts) == enum_count<E>(), "EnumVariant needs exactly one alternative per enumerator");
+    static_assert(enum_detail::all_of<std::is_nothrow_move_constructible<Ts>::value...>::value,
+                  "EnumVariant alternatives must be nothrow-move-constructible");
+
+public:
+    template <E Tag>
+    using alternative_t = std::tuple_element_t<static_cast<std::size_t>(Tag), std::tuple<Ts...>>;
+
+    /// Holds a value-initialized first alternative.
+    EnumVariant() : tag_(0)
+    {
+        new (&storage_) alternative_t<static_cast<E>(0)>();
+    }
+
+    EnumVariant(const EnumVariant &other) : tag_(other.tag_)
+    {
+        other.visit([this](const auto &value) { new (&storage_) std::decay_t<decltype(value)>(value); });
+    }
+
+    EnumVariant(EnumVariant &&other) noexcept : tag_(other.tag_)
+    {
+        take(other);
+    }
+
+    EnumVariant &operator=(const EnumVariant &other)
+    {
+        if (this != &other)
+        {
+            EnumVariant copy(other);
+            destroy();
+            tag_ = copy.tag_;
+            take(copy);
+        }
+        return *this;
+    }
+
+    EnumVariant &operator=(EnumVariant &&other) noexcept
+    {
+        if (this != &other)
+        {
+            destroy();
+            tag_ = other.tag_;
+            take(other);
+        }
+        return *this;
+    }
+
+    ~EnumVariant()
+    {
+        destroy();
+    }
+
+    /**
+     * @brief Variant holding alternative @p Tag constructed from @p args.
+     */
+    template <E Tag, typename... Args>
+    static EnumVariant make(Args &&...args)
+    {
+        return EnumVariant(in_place<Tag>{}, std::forward<Args>(args)...);
+    }
+
+    /**
+     * @brief Replace the held value with alternative @p Tag constructed from @p args.
+     */
+    template <E Tag, typename... Args>
+    alternative_t<Tag> &emplace(Args &&...args)
+    {
+        // build first so that the variant is unchanged if construction throws;
+        // the move below cannot throw
+        alternative_t<Tag> value(std::forward<Args>(args)...);
+        destroy();
+        auto *p = new (&storage_) alternative_t<Tag>(std::move(value));
+        tag_ = static_cast<tag_type>(Tag);
+        return *p;
+    }
+
+    E tag() const noexcept
+    {
+        return static_cast<E>(tag_);
+    }
+
+    template <E Tag>
+    alternative_t<Tag> *get_if() noexcept
+    {
+        return tag() == Tag ? reinterpret_cast<alternative_t<Tag> *>(&storage_) : nullptr;
+    }
+
+    template <E Tag>
+    const alternative_t<Tag> *get_if() const noexcept
+    {
+        return tag() == Tag ? reinterpret_cast<const alternative_t<Tag> *>(&storage_) : nullptr;
+    }
+
+    /**
+     * @throws std::logic_error naming both enumerators if @p Tag is not the active alternative
+     */
+    template <E Tag>
+    alternative_t<Tag> &get()
+    {
+        check<Tag>();
+        return *get_if<Tag>();
+    }
+
+    template <E Tag>
+    const alternative_t<Tag> &get() const
+    {
+        check<Tag>();
+        return *get_if<Tag>();
+    }
+
+    /**
+     * @brief Call f(value) with the active alternative; all calls must return the same type.
+     */
+    template <typename F>
+    decltype(auto) visit(F &&f)
+    {
+        using R = decltype(f(std::declval<std::tuple_element_t<0, std::tuple<Ts...>> &>()));
+        using fn = R (*)(F &, void *);
+        static constexpr fn table[] = {&call<R, F, Ts>...};
+        return table[tag_](f, &storage_);
+    }
+
+    template <typename F>
+    decltype(auto) visit(F &&f) const
+    {
+        using R = decltype(f(std::declval<const std::tuple_element_t<0, std::tuple<Ts...>> &>()));
+        using fn = R (*)(F &, const void *);
+        static constexpr fn table[] = {&call_const<R, F, Ts>...};
+        return table[tag_](f, &storage_);
+    }
+
+    friend std::ostream &operator<<(std::ostream &os, const EnumVariant &v)
+    {
+        os.write(enum_name(v.tag()), static_cast<std::streamsize>(enum_name_size(v.tag())));
+        v.visit([&os](const auto &value) {
+            using T = std::decay_t<decltype(value)>;
+            enum_detail::print_alternative(os, value, enum_detail::is_streamable<T>{});
+        });
+        return os;
+    }
+
+private:
+    using tag_type = enum_detail::least_uint_t<sizeof...(Ts)>;
+
+    template <E Tag>
+    struct in_place
+    {
+    };
+
+    /// Construct alternative @p Tag directly in the storage.
+    template <E Tag, typename... Args>
+    explicit EnumVariant(in_place<Tag>, Args &&...args) : tag_(static_cast<tag_type>(Tag))
+    {
+        new (&storage_) alternative_t<Tag>(std::forward<Args>(args)...);
+    }
+
+    template <typename R, typename F, typename T>
+    static R call(F &f, void *p)
+    {
+        return f(*static_cast<T *>(p));
+    }
+
+    template <typename R, typename F, typename T>
+    static R call_const(F &f, const void *p)
+    {
+        return f(*static_cast<const T *>(p));
+    }
+
+    template <E Tag>
+    void check() const
+    {
+        if (tag() != Tag)
+        {
+            throw std::logic_error(std::string("EnumVariant: ") + enum_name(Tag) + " requested but " +
+                                   enum_name(tag()) + " is active");
+        }
+    }
+
+    /// Move-construct the value of @p other, whose tag has already been copied.
+    void take(EnumVariant &other) noexcept
+    {
+        other.visit([this](auto &value) { new (&storage_) std::decay_t<decltype(value)>(std::move(value)); });
+    }
+
+    void destroy() noexcept
+    {
+        visit([](auto &value) {
+            using T = std::decay_t<decltype(value)>;
+            value.~T();
+        });
+    }
+
+    std::aligned_storage_t<enum_detail::max_of<sizeof(Ts)...>::value, enum_detail::max_of<alignof(Ts)...>::value>
+        storage_;
+    tag_type tag_;
+};
+
+#endif // ENUM_VARIANT_H
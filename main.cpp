@@ -1,24 +1,25 @@
 #include "enum.h"
+#include "enum_fd_reader.h"
+#include "enum_record.h"
+#include "enum_search.h"
+#include "enum_attribute.h"
+#include "enum_state.h"
+#include "enum_counters.h"
+#include "enum_set.h"
+#include "enum_runtime.h"
+#include "enum_registry.h"
+#include "enum_huffman.h"
+#include "enum_log_field.h"
+#include "enum_suggest.h"
+#include "enum_stream.h"
+#include "enum_variant.h"
 
 #include <sstream>
 #include <cassert>
-
-template <typename E>
-void test_to_from_string(E const e, std::string const s)
-{
-  assert(enum_to_string(e) == s);
-  assert(enum_from_string<E>(s) == e);
-}
-
-template <typename E>
-void test_stream_io(E const e)
-{
-  std::stringstream ss;
-  ss << e;
-  E v;
-  ss >> v;
-  assert(v == e);
-}
+#include <cstring>
+#include <atomic>
+#include <thread>
+#include <memory>
 
 ///////////////////////////////
 
@@ -58,6 +59,690 @@ namespace N3
 }
 ENUM_STRINGS(N3::Foo::NestedEnum, "fa", "fb");
 
+namespace N4
+{
+  enum class Status
+  {
+    Ok,
+    Error,
+    Timeout,
+    Time,
+    Out
+  };
+}
+ENUM_STRINGS(N4::Status, "OK", "ERROR", "TIMEOUT", "TIME", "OUT");
+
+struct is_terminal;
+struct severity;
+struct description;
+ENUM_ATTRIBUTE(N4::Status, is_terminal, bool, true, true, true, false, false);
+ENUM_ATTRIBUTE(N4::Status, severity, int, 0, 3, 2, 1, 1);
+ENUM_ATTRIBUTE(N4::Status, description, const char *, "done", "failed", "timed out", "time", "out");
+
+struct status_field;
+struct quoted_field;
+ENUM_LOG_FIELD(N4::Status, status_field, "status");
+ENUM_LOG_FIELD(N4::Status, quoted_field, "say \"hi\"");
+
+#define CORPUS_VALUES(P) P##0, P##1, P##2, P##3, P##4, P##5, P##6, P##7
+#define CORPUS_NAMES(P) #P "_0", #P "_1", #P "_2", #P "_3", #P "_4", #P "_5", #P "_6", #P "_7"
+enum class Corpus
+{
+  CORPUS_VALUES(A),
+  CORPUS_VALUES(B),
+  CORPUS_VALUES(C),
+  CORPUS_VALUES(D),
+  CORPUS_VALUES(E),
+  CORPUS_VALUES(F),
+  CORPUS_VALUES(G),
+  CORPUS_VALUES(H)
+};
+ENUM_STRINGS(Corpus, CORPUS_NAMES(A), CORPUS_NAMES(B), CORPUS_NAMES(C), CORPUS_NAMES(D),
+             CORPUS_NAMES(E), CORPUS_NAMES(F), CORPUS_NAMES(G), CORPUS_NAMES(H));
+
+// more than 64 names, so that bit sets of it span two words
+enum class Wide
+{
+  CORPUS_VALUES(A),
+  CORPUS_VALUES(B),
+  CORPUS_VALUES(C),
+  CORPUS_VALUES(D),
+  CORPUS_VALUES(E),
+  CORPUS_VALUES(F),
+  CORPUS_VALUES(G),
+  CORPUS_VALUES(H),
+  CORPUS_VALUES(I)
+};
+ENUM_STRINGS(Wide, CORPUS_NAMES(A), CORPUS_NAMES(B), CORPUS_NAMES(C), CORPUS_NAMES(D),
+             CORPUS_NAMES(E), CORPUS_NAMES(F), CORPUS_NAMES(G), CORPUS_NAMES(H), CORPUS_NAMES(I));
+
+// metadata budget of all the enumerations in the program, to catch layout regressions
+constexpr std::size_t metadata_budget = 4096;
+
+template <typename E>
+void test_to_from_string(E const e, std::string const s)
+{
+  assert(enum_to_string(e) == s);
+  assert(enum_from_string<E>(s) == e);
+}
+
+template <typename E>
+void test_stream_io(E const e)
+{
+  std::stringstream ss;
+  ss << e;
+  E v;
+  ss >> v;
+  assert(v == e);
+}
+
+template <typename E>
+void test_fd_reader(std::size_t buffer_size)
+{
+  std::string input;
+  std::vector<E> expected;
+  for (int i = 0; i < 1000; ++i)
+  {
+    const E e = static_cast<E>(i % enum_count<E>());
+    input += enum_to_string(e);
+    input += i % 7 == 0 ? "\n" : "  ";
+    expected.push_back(e);
+  }
+
+  int fds[2];
+  const int piped = ::pipe(fds);
+  assert(piped == 0);
+  (void)piped;
+  std::thread writer([&] {
+    for (std::size_t pos = 0; pos < input.size(); pos += 5)
+    {
+      const std::size_t n = std::min<std::size_t>(5, input.size() - pos);
+      const ssize_t written = ::write(fds[1], input.data() + pos, n);
+      assert(written == static_cast<ssize_t>(n));
+      (void)written;
+    }
+    ::close(fds[1]);
+  });
+
+  std::vector<E> actual(expected.size() + 1);
+  {
+    EnumFdReader<E> reader(fds[0], buffer_size, 3);
+    assert(reader.read(actual.data(), actual.size()) == expected.size());
+  }
+  actual.pop_back();
+  assert(actual == expected);
+  writer.join();
+  ::close(fds[0]);
+}
+
+void test_record_decoder()
+{
+  const std::string csv = "1,wb,x,sa\n"
+                          "2,wa,y,sb\r\n"
+                          "3,zz,,sa,tail,tail,tail,tail,tail,tail,tail,tail\n"
+                          "4,wb\n"
+                          "5,wa,z,sb";
+  EnumRecordDecoder<N2::StrongEnum, N1::WeakEnum> decoder(std::array<std::size_t, 2>{{3, 1}});
+  EnumRecordDecoder<N2::StrongEnum, N1::WeakEnum>::columns_type out;
+  std::vector<EnumRecordError> errors;
+  assert(decoder.decode(csv.data(), csv.data() + csv.size(), out, &errors) == 5);
+
+  const auto &strong = std::get<0>(out);
+  const auto &weak = std::get<1>(out);
+  assert((strong == std::vector<N2::StrongEnum>{N2::StrongEnum::A, N2::StrongEnum::B, N2::StrongEnum::A,
+                                                N2::StrongEnum::A, N2::StrongEnum::B}));
+  assert((weak == std::vector<N1::WeakEnum>{N1::B, N1::A, N1::A, N1::B, N1::A}));
+  assert(errors.size() == 2);
+  assert(errors[0].row == 2 && errors[0].column == 1);
+  assert(errors[1].row == 3 && errors[1].column == 3);
+}
+
+void test_find_all()
+{
+  using N4::Status;
+  const std::string line = "TIMEOUT ERROR: OK";
+  const auto matches = enum_find_all<Status>(line.data(), line.data() + line.size());
+  const std::vector<std::pair<std::size_t, Status>> expected = {
+      {0, Status::Time}, {0, Status::Timeout}, {4, Status::Out}, {8, Status::Error}, {15, Status::Ok}};
+  assert(matches == expected);
+  assert(enum_find_all<Status>(line.data(), line.data()).empty());
+
+  // one pass over the names of several enumerations; Corpus and Wide share
+  // the name "A_0", which is reported for both
+  const std::string log = "ERROR fasb A_0 I_1";
+  std::ostringstream found;
+  enum_find_all<Status, N2::StrongEnum, N3::Foo::NestedEnum, Corpus, Wide>(
+      log.data(), log.data() + log.size(), [&](std::size_t offset, auto e) {
+        found << offset << e << '/' << enum_count<decltype(e)>() << ' ';
+      });
+  assert(found.str() == "0ERROR/5 6fa/2 8sb/2 11A_0/64 11A_0/72 15I_1/72 ");
+}
+
+void test_attributes()
+{
+  using N4::Status;
+  assert(enum_attribute<is_terminal>(Status::Error));
+  assert(!enum_attribute<is_terminal>(Status::Time));
+  assert(!enum_attribute<is_terminal>(static_cast<Status>(42)));
+  assert((enum_attribute_mask<is_terminal, Status>()[0] == 0x7));
+  assert(enum_attribute<severity>(Status::Timeout) == 2);
+  assert(enum_attribute<severity>(static_cast<Status>(42)) == 0);
+  assert(std::string(enum_attribute<description>(Status::Error)) == "failed");
+  constexpr auto severities = EnumAttributeInfo<Status, severity>::Values();
+  static_assert(severities[1] == 3, "");
+}
+
+void test_state_machine()
+{
+  using N4::Status;
+  static constexpr auto transitions = make_enum_transitions<Status>({
+      {"TIME", "OUT"},
+      {"TIME", "OK"},
+      {"OUT", "TIMEOUT"},
+      {"OUT", "ERROR"},
+  });
+  static_assert(transitions.allowed(Status::Time, Status::Out), "");
+  static_assert(!transitions.allowed(Status::Out, Status::Time), "");
+
+  AtomicEnumState<Status> state(transitions, Status::Time);
+  assert(!state.try_transition(Status::Out, Status::Error));
+  assert(state.try_transition(Status::Time, Status::Out));
+  assert(state.load() == Status::Out);
+  assert(state.transition(Status::Error) == Status::Out);
+  try
+  {
+    state.transition(Status::Ok);
+    assert(false);
+  }
+  catch (const std::logic_error &e)
+  {
+    assert(std::string(e.what()) == "invalid transition ERROR -> OK");
+  }
+  assert(state.load() == Status::Error);
+}
+
+void test_counters()
+{
+  using N4::Status;
+  static EnumCounters<Status, 4> counters;
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 8; ++t)
+  {
+    threads.emplace_back([t] {
+      for (int i = 0; i < 10000; ++i)
+      {
+        counters.add(static_cast<Status>(t % 2));
+      }
+      counters.add(Status::Out, 5);
+      counters.add(static_cast<Status>(42));
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  assert(counters.value(Status::Ok) == 40000);
+  assert(counters.value(Status::Error) == 40000);
+  assert(counters.value(Status::Out) == 40);
+  assert(counters.snapshot()[enum_index(Status::Time)] == 0);
+
+  std::string report;
+  counters.for_each([&](const char *name, std::uint64_t count) {
+    report += name;
+    report += '=' + std::to_string(count) + ' ';
+  });
+  assert(report == "OK=40000 ERROR=40000 TIMEOUT=0 TIME=0 OUT=40 ");
+  counters.reset();
+  assert(counters.value(Status::Ok) == 0);
+
+  // shards are padded rather than over-aligned, so heap allocation keeps them on separate lines
+  static_assert(sizeof(EnumCounters<Status, 2>) >= 2 * (enum_count<Status>() * 8 + 64), "");
+  const auto heap = std::make_unique<EnumCounters<Status, 2>>();
+  heap->add(Status::Time, 3);
+  assert(heap->value(Status::Time) == 3);
+}
+
+void test_atomic_set()
+{
+  using N4::Status;
+  AtomicEnumSet<Status> flags;
+  assert(flags.insert(Status::Error));
+  assert(!flags.insert(Status::Error));
+  assert(!flags.insert(static_cast<Status>(42)));
+
+  std::vector<std::thread> threads;
+  for (int t = 0; t < 4; ++t)
+  {
+    threads.emplace_back([&flags, t] {
+      const Status mine = static_cast<Status>(2 + t % 3);
+      for (int i = 0; i < 1000; ++i)
+      {
+        flags.insert(mine);
+        flags.erase(mine);
+      }
+      flags.insert(mine);
+    });
+  }
+  for (auto &thread : threads)
+  {
+    thread.join();
+  }
+  assert(flags.test(Status::Timeout) && flags.test(Status::Out));
+  assert(!flags.test(Status::Ok));
+  assert(flags.erase(Status::Time));
+  assert(!flags.erase(Status::Time));
+
+  const EnumSet<Status> snapshot = flags.snapshot();
+  assert(snapshot.size() == 3);
+  std::ostringstream os;
+  os << snapshot;
+  assert(os.str() == "{ERROR, TIMEOUT, OUT}");
+
+  EnumSet<Status> other;
+  other.insert(Status::Ok);
+  other.insert(Status::Error);
+  std::ostringstream ops;
+  ops << (snapshot | other) << (snapshot & other) << (snapshot - other);
+  assert(ops.str() == "{OK, ERROR, TIMEOUT, OUT}{ERROR}{TIMEOUT, OUT}");
+  static_assert(sizeof(AtomicEnumSet<Status>) == 2 * sizeof(std::uint64_t), "");
+}
+
+void test_atomic_set_across_words()
+{
+  static_assert(AtomicEnumSet<Wide>::word_count == 2, "");
+  static_assert(alignof(AtomicEnumSet<Wide>) == enum_detail::cache_line_size, "");
+  // I0 (word 1) is only ever a member while A0 (word 0) is: one thread
+  // toggles A0, another inserts and erases I0 as soon as it sees A0
+  AtomicEnumSet<Wide> flags;
+  constexpr int rounds = 2000;
+  std::atomic<int> done{0};
+  std::atomic<int> cleared{0};
+  std::atomic<bool> stop{false};
+  std::thread first([&] {
+    for (int r = 1; r <= rounds; ++r)
+    {
+      flags.insert(Wide::A0);
+      while (done.load() != r)
+      {
+        std::this_thread::yield();
+      }
+      flags.erase(Wide::A0);
+      cleared.store(r);
+    }
+  });
+  std::thread second([&] {
+    for (int r = 1; r <= rounds; ++r)
+    {
+      while (!flags.test(Wide::A0))
+      {
+        std::this_thread::yield();
+      }
+      flags.insert(Wide::I0);
+      flags.erase(Wide::I0);
+      done.store(r);
+      while (cleared.load() != r)
+      {
+        std::this_thread::yield();
+      }
+    }
+  });
+  std::thread reader([&] {
+    while (!stop.load())
+    {
+      const EnumSet<Wide> snapshot = flags.snapshot();
+      assert(!snapshot.test(Wide::I0) || snapshot.test(Wide::A0));
+      std::this_thread::yield();
+    }
+  });
+  first.join();
+  second.join();
+  stop.store(true);
+  reader.join();
+  assert(flags.snapshot().size() == 0);
+}
+
+void test_runtime_enum()
+{
+  std::vector<std::string> names;
+  for (int i = 0; i < 10000; ++i)
+  {
+    names.push_back("VENUE_" + std::to_string(i));
+  }
+  const RuntimeEnum venues(names);
+  assert(venues.size() == names.size());
+  for (RuntimeEnum::value_type i = 0; i < venues.size(); ++i)
+  {
+    RuntimeEnum::value_type v = 0;
+    assert(venues.to_string(i) == names[i]);
+    assert(venues.from_chars(names[i].data(), names[i].data() + names[i].size(), v) && v == i);
+  }
+  RuntimeEnum::value_type v = 0;
+  const char unknown[] = "VENUE_10000";
+  assert(!venues.from_chars(unknown, unknown + sizeof(unknown) - 1, v));
+  assert(venues.name(10000) == nullptr && venues.name_size(10000) == 0);
+  assert(!RuntimeEnum().from_chars(unknown, unknown, v));
+
+  bool thrown = false;
+  try
+  {
+    RuntimeEnum({"a", "b", "a"});
+  }
+  catch (const std::invalid_argument &)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void test_extensible_registry()
+{
+  ExtensibleEnumRegistry registry({"NEW", "ACK"});
+  std::atomic<bool> done{false};
+  std::vector<std::thread> readers;
+  for (int t = 0; t < 4; ++t)
+  {
+    readers.emplace_back([&] {
+      ExtensibleEnumRegistry::Reader reader(registry);
+      while (!done.load())
+      {
+        reader.refresh();
+        const RuntimeEnum &table = reader.table();
+        for (ExtensibleEnumRegistry::value_type v = 0; v < table.size(); ++v)
+        {
+          ExtensibleEnumRegistry::value_type parsed = 0;
+          const char *name = reader.name(v);
+          assert(reader.from_chars(name, name + reader.name_size(v), parsed) && parsed == v);
+          (void)name;
+        }
+      }
+    });
+  }
+  for (int i = 0; i < 200; ++i)
+  {
+    assert(registry.add("PLUGIN_" + std::to_string(i)) == static_cast<ExtensibleEnumRegistry::value_type>(i + 2));
+  }
+  assert(registry.add("ACK") == 1);
+  assert((registry.add({"X", "PLUGIN_3", "X"}) == std::vector<ExtensibleEnumRegistry::value_type>{202, 5, 202}));
+  done = true;
+  for (auto &thread : readers)
+  {
+    thread.join();
+  }
+
+  ExtensibleEnumRegistry::Reader reader(registry);
+  assert(reader.table().size() == 203);
+  registry.collect();
+  assert(registry.retired() == 0);
+}
+
+void test_static_string_map()
+{
+  static constexpr auto headers = make_static_string_map<int>({
+      {"Content-Type", 1},
+      {"Content-Length", 2},
+      {"Host", 3},
+  });
+  static_assert(headers.size() == 3, "");
+  static_assert(*headers.find("Host", "Host" + 4) == 3, "");
+  static_assert(headers.find("Hos", "Hos" + 3) == nullptr, "");
+  assert(*headers.find(std::string("Content-Length")) == 2);
+  assert(headers.find(std::string("content-length")) == nullptr);
+  assert(std::string(headers.key(0)) == "Content-Type" && headers.value(0) == 1);
+}
+
+void test_huffman()
+{
+  using N4::Status;
+  std::vector<Status> events;
+  for (int i = 0; i < 10000; ++i)
+  {
+    events.push_back(i % 50 == 0 ? Status::Error : i % 10 == 0 ? Status::Timeout : Status::Ok);
+  }
+  const EnumHuffmanCodec<Status> codec(EnumHuffmanCodec<Status>::measure(&events.front(), &events.back() + 1));
+  assert(codec.code_lengths()[enum_index(Status::Ok)] == 1);
+  assert(codec.code_lengths()[enum_index(Status::Time)] == 0);
+
+  std::vector<std::uint8_t> encoded;
+  codec.encode(&events.front(), &events.back() + 1, encoded);
+  assert(encoded.size() == (codec.encoded_bits(&events.front(), &events.back() + 1) + 7) / 8);
+  // well below the 3 bits per value of plain bit packing
+  assert(encoded.size() * 8 < events.size() * 3 / 2);
+
+  const auto stored = EnumHuffmanCodec<Status>::from_code_lengths(codec.code_lengths());
+  std::vector<Status> decoded(events.size());
+  stored.decode(encoded.data(), encoded.size(), decoded.data(), decoded.size());
+  assert(decoded == events);
+
+  bool thrown = false;
+  try
+  {
+    stored.decode(encoded.data(), encoded.size() / 2, decoded.data(), decoded.size());
+  }
+  catch (const std::invalid_argument &)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+
+  thrown = false;
+  const Status unencodable = Status::Time;
+  try
+  {
+    codec.encode(&unencodable, &unencodable + 1, encoded);
+  }
+  catch (const std::invalid_argument &)
+  {
+    thrown = true;
+  }
+  assert(thrown);
+}
+
+void test_log_fragments()
+{
+  using N4::Status;
+  const EnumFragment kv = enum_kv_fragment<status_field>(Status::Timeout);
+  assert(std::string(kv.data, kv.size) == "status=TIMEOUT");
+  assert(kv.data[kv.size] == '\0');
+  const EnumFragment json = enum_json_fragment<status_field>(Status::Ok);
+  assert(std::string(json.data, json.size) == "\"status\":\"OK\"");
+  const EnumFragment escaped = enum_json_fragment<quoted_field>(Status::Out);
+  assert(std::string(escaped.data, escaped.size) == "\"say \\\"hi\\\"\":\"OUT\"");
+  assert(enum_kv_fragment<status_field>(static_cast<Status>(42)).size == 0);
+}
+
+template <typename E>
+bool suggest(const std::string &query, E &e, std::size_t max_distance = 2)
+{
+  return enum_suggest(query.data(), query.data() + query.size(), e, max_distance);
+}
+
+void test_suggestions()
+{
+  using N4::Status;
+  Status s{};
+  assert(suggest("EROR", s) && s == Status::Error);
+  assert(suggest("TIMOUT", s) && s == Status::Timeout);
+  assert(suggest("TIEM", s) && s == Status::Time);
+  assert(suggest("OUT", s) && s == Status::Out);
+  assert(suggest("", s, 2) && s == Status::Ok);
+  assert(!suggest("CANCELLED", s));
+  assert(!suggest("EROR", s, 0));
+  assert(!suggest(std::string(100, 'x'), s));
+
+  // cross-check the bit-parallel distance against the dynamic-programming one
+  const char *words[] = {"kitten", "sitting", "flaw", "lawn", "", "a", "abcdefgh", "hgfedcba"};
+  for (const char *a : words)
+  {
+    for (const char *b : words)
+    {
+      const std::size_t m = std::strlen(a);
+      const std::size_t n = std::strlen(b);
+      if (m == 0)
+      {
+        continue;
+      }
+      std::uint64_t peq[256] = {};
+      for (std::size_t i = 0; i < m; ++i)
+      {
+        peq[static_cast<unsigned char>(a[i])] |= std::uint64_t{1} << i;
+      }
+      assert(enum_detail::bit_parallel_distance(peq, m, b, n, 64) == enum_detail::dp_distance(a, m, b, n));
+    }
+  }
+}
+
+void test_range_io()
+{
+  using N4::Status;
+  std::vector<Status> values;
+  for (int i = 0; i < 5000; ++i)
+  {
+    values.push_back(static_cast<Status>(i % enum_count<Status>()));
+  }
+  std::stringstream ss;
+  ss << enum_range(values);
+  assert(ss.str().compare(0, 23, "OK ERROR TIMEOUT TIME O") == 0);
+
+  std::vector<Status> parsed;
+  ss >> enum_range(parsed);
+  assert(parsed == values);
+  assert(ss.eof() && !ss.fail());
+
+  std::ostringstream csv;
+  const std::vector<Status> few = {Status::Out, Status::Ok};
+  csv << enum_range(few, ',');
+  assert(csv.str() == "OUT,OK");
+
+  // an unnamed value cannot be read back: writing stops there with failbit
+  std::ostringstream unnamed;
+  const std::vector<Status> gaps = {Status::Ok, static_cast<Status>(99), Status::Timeout};
+  unnamed << enum_range(gaps, ',');
+  assert(unnamed.str() == "OK" && unnamed.fail() && !unnamed.bad());
+
+  // and empty fields are reported instead of being merged
+  for (const char *text : {"OK,,OUT", ",OK", "OK,", "OK, ,OUT"})
+  {
+    std::istringstream in(text);
+    std::vector<Status> read;
+    in >> enum_range(read, ',');
+    assert(in.fail() && read.size() <= 1);
+  }
+  std::istringstream spaced(" OK , OUT\n");
+  std::vector<Status> read;
+  spaced >> enum_range(read, ',');
+  assert(!spaced.fail() && (read == std::vector<Status>{Status::Ok, Status::Out}));
+
+  std::istringstream bad("OK,\nERROR,NOPE,OUT");
+  std::vector<Status> partial;
+  bad >> enum_range(partial, ',');
+  assert(bad.fail());
+  assert((partial == std::vector<Status>{Status::Ok, Status::Error}));
+}
+
+void test_footprint()
+{
+  constexpr EnumFootprint corpus = enum_footprint<Corpus>();
+  static_assert(corpus.name_bytes == 64 * 4, "");
+  static_assert(corpus.table_bytes == 64 * (sizeof(const char *) + sizeof(std::uint32_t)), "");
+  static_assert(corpus.lookup_bytes >= 128 * sizeof(std::uint32_t), "");
+  static_assert(enum_total_footprint<>().total() == 0, "");
+  static_assert(enum_total_footprint<Corpus, Wide>().total() ==
+                    enum_footprint<Corpus>().total() + enum_footprint<Wide>().total(), "");
+
+  // every ENUM_STRINGS enumeration registers itself exactly once
+  assert(enum_registered_count() == 6);
+  const EnumFootprint all = enum_registered_footprint();
+  constexpr EnumFootprint listed =
+      enum_total_footprint<N1::WeakEnum, N2::StrongEnum, N3::Foo::NestedEnum, N4::Status, Corpus, Wide>();
+  assert(all.total() == listed.total());
+  assert(all.total() <= metadata_budget);
+  assert(enum_from_string<Corpus>("H_7") == Corpus::H7);
+
+  const RuntimeEnum venues({"XNYS", "XNAS"});
+  assert(venues.memory_bytes() >= 10 + 3 * sizeof(std::uint32_t));
+}
+
+struct Opaque
+{
+  int id;
+};
+
+struct Picky
+{
+  explicit Picky(int value) : value(value)
+  {
+    if (value < 0)
+    {
+      throw std::invalid_argument("negative");
+    }
+  }
+  int value;
+};
+
+void test_variant()
+{
+  using N4::Status;
+  using Message = EnumVariant<Status, int, std::string, double, Opaque, std::vector<int>>;
+  static_assert(sizeof(Message) == sizeof(std::string) + alignof(std::string), "");
+  static_assert(sizeof(EnumVariant<N1::WeakEnum, std::uint32_t, std::uint16_t>) == 8, "");
+  static_assert(sizeof(EnumVariant<N1::WeakEnum, std::uint64_t, char>) == sizeof(std::uint64_t) + alignof(std::uint64_t), "");
+  static_assert(std::is_nothrow_move_constructible<Message>::value, "");
+  static_assert(std::is_nothrow_move_assignable<Message>::value, "");
+
+  Message m;
+  assert(m.tag() == Status::Ok && m.get<Status::Ok>() == 0);
+  m.emplace<Status::Error>("disk full");
+  assert(m.tag() == Status::Error);
+  assert(*m.get_if<Status::Error>() == "disk full");
+  assert(m.get_if<Status::Ok>() == nullptr);
+
+  std::ostringstream os;
+  os << m << ' ' << Message::make<Status::Time>(Opaque{7});
+  assert(os.str() == "ERROR(disk full) TIME");
+
+  const Message copy = m;
+  const std::size_t size = copy.visit([](const auto &value) { return sizeof(value); });
+  assert(size == sizeof(std::string));
+
+  Message moved = Message::make<Status::Out>(std::vector<int>{1, 2, 3});
+  m = std::move(moved);
+  assert(m.get<Status::Out>().size() == 3);
+  m = copy;
+  assert(m.get<Status::Error>() == "disk full");
+
+  try
+  {
+    m.get<Status::Timeout>();
+    assert(false);
+  }
+  catch (const std::logic_error &e)
+  {
+    assert(std::string(e.what()) == "EnumVariant: TIMEOUT requested but ERROR is active");
+  }
+
+  // a throwing construction leaves the variant as it was
+  using Guarded = EnumVariant<N2::StrongEnum, std::string, Picky>;
+  Guarded g = Guarded::make<N2::StrongEnum::A>("kept");
+  try
+  {
+    g.emplace<N2::StrongEnum::B>(-1);
+    assert(false);
+  }
+  catch (const std::invalid_argument &)
+  {
+  }
+  assert(g.get<N2::StrongEnum::A>() == "kept");
+  g.emplace<N2::StrongEnum::B>(5);
+  assert(g.get<N2::StrongEnum::B>().value == 5);
+
+  // make() builds the requested alternative only, so the first one need not be default-constructible
+  using NoDefault = EnumVariant<N2::StrongEnum, Picky, std::string>;
+  static_assert(!std::is_default_constructible<Picky>::value, "");
+  const NoDefault named = NoDefault::make<N2::StrongEnum::B>("x");
+  assert(named.get<N2::StrongEnum::B>() == "x");
+  assert(NoDefault::make<N2::StrongEnum::A>(3).get<N2::StrongEnum::A>().value == 3);
+}
+
 ///////////////////////////////
 
 int main()
@@ -79,5 +764,34 @@ int main()
 
   auto array1 = to_array<uint32_t>({1, 2, 3, 4});
 
+  static_assert(enum_count<N2::StrongEnum>() == 2, "");
+  assert(enum_name_size(N2::StrongEnum::B) == 2);
+  assert(enum_name(static_cast<N2::StrongEnum>(2)) == nullptr);
+  assert(enum_to_string(static_cast<N2::StrongEnum>(-1)).empty());
+  N2::StrongEnum strong{};
+  const char sb[] = "sbx";
+  assert(enum_from_chars(sb, sb + 2, strong) && strong == N2::StrongEnum::B);
+  assert(!enum_from_chars(sb, sb + 3, strong));
+
+  test_fd_reader<N1::WeakEnum>(1);
+  test_fd_reader<N3::Foo::NestedEnum>(64 * 1024);
+
+  test_record_decoder();
+  test_find_all();
+  test_attributes();
+  test_state_machine();
+  test_counters();
+  test_atomic_set();
+  test_atomic_set_across_words();
+  test_runtime_enum();
+  test_extensible_registry();
+  test_static_string_map();
+  test_huffman();
+  test_log_fragments();
+  test_suggestions();
+  test_range_io();
+  test_footprint();
+  test_variant();
+
   return 0;
 }
\ No newline at end of file